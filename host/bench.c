@@ -0,0 +1,257 @@
+// Copyright 2015-16 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Render benchmark: runs the watchface against the host SDK and times the
+// background update procedure for every date format over 12 hours of minute
+// positions.  With --seconds, the seconds pointer is shown and the positions
+// are seconds instead.  With --no-advance-tables, text is measured without the
+// glyph advance tables (to compare the "measure" stage).  The render path must
+// not touch the heap: after the warmup, any frame that allocates is reported
+// and the benchmark fails.
+//
+// usage: obsidian-bench-<platform> [--positions N] [--format F] [--seconds]
+//                                  [--no-advance-tables]
+
+#include "host.h"
+#include "../src/obsidian.h"
+
+void init();
+void deinit();
+
+#define BENCH_FORMATS 18
+#define BENCH_POSITIONS 720
+#define BENCH_WARMUP 10
+// Monday, 17 October 2016, 00:00 UTC
+#define BENCH_START_TIME 1476662400
+
+static const char *format_names[BENCH_FORMATS] = {
+        "Mon // Oct 22",
+        "Oct 22",
+        "10/22",
+        "22.10.",
+        "22",
+        "Mon 22",
+        "Mon",
+        "14:10",
+        "2:10",
+        "2:10 // 10/22",
+        "14:10 // 10/22",
+        "Mon // 10/22",
+        "2:10 // 22.10.",
+        "14:10 // 22.10.",
+        "Mon // 22.10.",
+        "2:10 | Mon 22",
+        "14:10 | Mon 22",
+        "Mon // 22 Oct",
+};
+
+/** Totals over all formats, per stage. */
+static HostStage stage_totals[HOST_MAX_STAGES];
+static int stage_total_count;
+
+/** Number of measured frames that allocated heap memory (there should be none). */
+static int allocating_frames;
+
+/** Whether to benchmark with the seconds pointer (one position per second). */
+static bool seconds_mode;
+
+/** Whether text is measured with the glyph advance tables. */
+static bool advance_tables = true;
+
+static void send_config(uint8_t date_format) {
+    DictionaryIterator *iter = host_message_begin();
+    dict_write_uint8(iter, CONFIG_DATE_FORMAT, date_format);
+    dict_write_uint8(iter, CONFIG_SECONDS, seconds_mode ? 1 : 0);
+    dict_write_uint16(iter, CONFIG_WEATHER_EXPIRATION, 0xffff);
+    host_message_deliver();
+    host_advance_ms(0);
+    // the date format may have loaded the other variant of the main font, with new advance tables
+    if (!advance_tables) {
+        advance_tables_destroy();
+    }
+}
+
+static void send_weather(void) {
+    DictionaryIterator *iter = host_message_begin();
+    dict_write_int8(iter, MSG_KEY_WEATHER_ICON, 'a');
+    dict_write_int8(iter, MSG_KEY_WEATHER_TEMP, 21);
+    host_message_deliver();
+    host_advance_ms(0);
+}
+
+/** Moves the clock to the given position and delivers the tick, but does not render. */
+static void tick_at(int position) {
+    if (seconds_mode) {
+        host_set_time(BENCH_START_TIME + position);
+        host_tick(position % 60 == 0 ? SECOND_UNIT | MINUTE_UNIT : SECOND_UNIT);
+    } else {
+        host_set_time(BENCH_START_TIME + position * 60);
+        host_tick(MINUTE_UNIT);
+    }
+}
+
+static void render_at(int position) {
+    tick_at(position);
+    host_render();
+}
+
+static void accumulate_stages(void) {
+    for (int i = 0; i < host_stage_count; i++) {
+        int j;
+        for (j = 0; j < stage_total_count; j++) {
+            if (strcmp(stage_totals[j].name, host_stages[i].name) == 0) break;
+        }
+        if (j == stage_total_count) {
+            stage_totals[j].name = host_stages[i].name;
+            stage_total_count += 1;
+        }
+        stage_totals[j].ns += host_stages[i].ns;
+        stage_totals[j].draw_calls += host_stages[i].draw_calls;
+    }
+}
+
+static void print_header(void) {
+    printf("%-3s %-16s %9s %7s %7s", "fmt", "format", "us/frame", "calls", "allocs");
+    for (int i = 0; i < host_stage_count; i++) {
+        printf(" %10.10s", host_stages[i].name);
+    }
+    printf("\n");
+}
+
+/**
+ * Renders all positions with one date format and prints one row of the table.
+ */
+static uint64_t bench_format(uint8_t date_format, int positions, bool header) {
+    send_config(date_format);
+    for (int i = 0; i < BENCH_WARMUP; i++) {
+        render_at(i);
+    }
+
+    host_profile_reset();
+    const uint64_t draw_calls = host_stats.draw_calls;
+    const uint64_t allocations = host_stats.allocations;
+    uint64_t ns = 0;
+    for (int i = 0; i < positions; i++) {
+        tick_at(i);
+        const uint64_t frame_allocations = host_stats.allocations;
+        const uint64_t start = host_now_ns();
+        host_render();
+        ns += host_now_ns() - start;
+        if (host_stats.allocations != frame_allocations) {
+            allocating_frames += 1;
+        }
+    }
+
+    if (header) print_header();
+    printf("%3d %-16s %9.1f %7.1f %7.1f", date_format, format_names[date_format], ns / 1000.0 / positions,
+           (double) (host_stats.draw_calls - draw_calls) / positions,
+           (double) (host_stats.allocations - allocations) / positions);
+    for (int i = 0; i < host_stage_count; i++) {
+        printf(" %10.1f", host_stages[i].ns / 1000.0 / positions);
+    }
+    printf("\n");
+    accumulate_stages();
+    return ns;
+}
+
+static void print_stage_table(int frames) {
+    uint64_t total = 0;
+    for (int i = 0; i < stage_total_count; i++) {
+        total += stage_totals[i].ns;
+    }
+    printf("\n%-12s %9s %7s %11s\n", "stage", "us/frame", "share", "calls/frame");
+    for (int i = 0; i < stage_total_count; i++) {
+        printf("%-12s %9.1f %6.1f%% %11.2f\n", stage_totals[i].name, stage_totals[i].ns / 1000.0 / frames,
+               total ? 100.0 * stage_totals[i].ns / total : 0.0, (double) stage_totals[i].draw_calls / frames);
+    }
+}
+
+/**
+ * Prints the time of every startup phase of both launches (they go through the same phases).
+ */
+static void print_startup_table(HostStage startup[2][HOST_MAX_STAGES], int count) {
+    uint64_t total[2] = {0, 0};
+    printf("\n%-13s %12s %12s\n", "startup (us)", "first", "relaunch");
+    for (int i = 0; i < count; i++) {
+        printf("%-13s %12.1f %12.1f\n", startup[0][i].name, startup[0][i].ns / 1000.0, startup[1][i].ns / 1000.0);
+        total[0] += startup[0][i].ns;
+        total[1] += startup[1][i].ns;
+    }
+    printf("%-13s %12.1f %12.1f\n", "total", total[0] / 1000.0, total[1] / 1000.0);
+}
+
+int main(int argc, char **argv) {
+    int positions = BENCH_POSITIONS;
+    int only_format = -1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--positions") == 0 && i + 1 < argc) {
+            positions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            only_format = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seconds") == 0) {
+            seconds_mode = true;
+        } else if (strcmp(argv[i], "--no-advance-tables") == 0) {
+            advance_tables = false;
+        } else {
+            fprintf(stderr, "usage: %s [--positions N] [--format F] [--seconds] [--no-advance-tables]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (positions <= 0) positions = 1;
+
+    // make the output independent of the machine
+    setenv("TZ", "UTC", 1);
+    setenv("LC_ALL", "C", 1);
+    tzset();
+
+    host_set_time(BENCH_START_TIME);
+    // the first launch stores the default configuration, the second one is what every later launch looks like; a
+    // launch ends with the first frame and what is initialized after it
+    HostStage startup[2][HOST_MAX_STAGES];
+    int startup_count = 0;
+    for (int launch = 0; launch < 2; launch++) {
+        const uint64_t reads = host_stats.persist_reads;
+        const uint64_t writes = host_stats.persist_writes;
+        host_startup_reset();
+        init();
+        host_render();
+        host_advance_ms(0);
+        printf("%s: %d persist reads, %d persist writes\n", launch == 0 ? "first launch" : "relaunch",
+               (int) (host_stats.persist_reads - reads), (int) (host_stats.persist_writes - writes));
+        memcpy(startup[launch], host_startup_phases, sizeof(host_startup_phases));
+        startup_count = host_startup_phase_count;
+        if (launch == 0) deinit();
+    }
+    print_startup_table(startup, startup_count);
+    send_weather();
+
+    printf("\nplatform %s (%dx%d), %d %s positions per format\n\n", OBSIDIAN_HOST_PLATFORM, PBL_DISPLAY_WIDTH,
+           PBL_DISPLAY_HEIGHT, positions, seconds_mode ? "second" : "minute");
+    uint64_t ns = 0;
+    int frames = 0;
+    for (int f = 0; f < BENCH_FORMATS; f++) {
+        if (only_format >= 0 && f != only_format) continue;
+        ns += bench_format((uint8_t) f, positions, frames == 0);
+        frames += positions;
+    }
+    print_stage_table(frames);
+    printf("\ntotal: %.1f us/frame over %d frames\n", ns / 1000.0 / frames, frames);
+
+    deinit();
+    if (allocating_frames > 0) {
+        fprintf(stderr, "error: %d frames allocated heap memory\n", allocating_frames);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+// Copyright 2015-16 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Clipping microbenchmark: times line2_rect_intersect (src/geometry.c), the
+// test of the label placement searches whether a rectangle touches a hand,
+// against the implementation it replaced (four segment-segment tests per hand,
+// copied below).  The candidates are the hands at all 720 minute positions
+// against label-sized rectangles all over the screen.  Every answer is also
+// checked against an exact reference; the benchmark fails if
+// line2_rect_intersect disagrees with it.
+//
+// usage: obsidian-clip-bench-<platform> [--passes N] [--step S]
+
+#include "host.h"
+#include "../src/obsidian.h"
+
+/** Rectangle sizes of the candidates (date, weather and battery labels). */
+static const GSize rect_sizes[] = {{70, 28}, {50, 22}, {24, 14}};
+
+typedef struct {
+    GPoint hour_hand;
+    GPoint minute_hand;
+    GPoint rect0;
+    GPoint rect1;
+} Candidate;
+
+////////////////////////////////////////////
+//// The implementation before the outcode test
+////////////////////////////////////////////
+
+static bool old_intersect(const GPoint a0, const GPoint a1, const GPoint b0, const GPoint b1) {
+    GPoint va = GPoint(a1.x - a0.x, a1.y - a0.y);
+    GPoint vb = GPoint(b1.x - b0.x, b1.y - b0.y);
+
+    int16_t det = vb.x * va.y - va.x * vb.y;
+    if (det == 0) {
+        if ((b0.x - a0.x) * va.y == (b0.y - a0.y) * va.x) {
+            return (0 <= b0.x - a0.x && b0.x - a0.x <= va.x) || (0 <= a0.x - b0.x && a0.x - b0.x <= vb.x);
+        } else {
+            return false;
+        }
+    }
+
+    int16_t s = ((a0.x - b0.x) * va.y - (a0.y - b0.y) * va.x);
+    int16_t t = -(-(a0.x - b0.x) * vb.y + (a0.y - b0.y) * vb.x);
+
+    if (det < 0) {
+        det = -det;
+        s = -s;
+        t = -t;
+    }
+    return 0 <= s && s <= det && 0 <= t && t <= det;
+}
+
+static bool old_line_rect_intersect(GPoint line0, GPoint line1, GPoint rect0, GPoint rect1) {
+    return old_intersect(line0, line1, rect0, GPoint(rect1.x, rect0.y)) ||
+           old_intersect(line0, line1, rect0, GPoint(rect0.x, rect1.y)) ||
+           old_intersect(line0, line1, rect1, GPoint(rect1.x, rect0.y)) ||
+           old_intersect(line0, line1, rect1, GPoint(rect0.x, rect1.y));
+}
+
+// not inlined, like line2_rect_intersect (which is in another translation unit)
+__attribute__((noinline))
+static bool old_line2_rect_intersect(GPoint lineA0, GPoint lineA1, GPoint lineB0, GPoint lineB1, GPoint rect0,
+                                     GPoint rect1) {
+    return old_line_rect_intersect(lineA0, lineA1, rect0, rect1) ||
+           old_line_rect_intersect(lineB0, lineB1, rect0, rect1);
+}
+
+////////////////////////////////////////////
+//// Exact reference
+////////////////////////////////////////////
+
+static int orientation(const GPoint a, const GPoint b, const GPoint c) {
+    const int64_t cross = (int64_t) (b.x - a.x) * (c.y - a.y) - (int64_t) (b.y - a.y) * (c.x - a.x);
+    return (cross > 0) - (cross < 0);
+}
+
+/** Does c, which is on the line through a and b, lie on the segment a->b? */
+static bool on_segment(const GPoint a, const GPoint b, const GPoint c) {
+    return c.x >= (a.x < b.x ? a.x : b.x) && c.x <= (a.x < b.x ? b.x : a.x) &&
+           c.y >= (a.y < b.y ? a.y : b.y) && c.y <= (a.y < b.y ? b.y : a.y);
+}
+
+static bool segments_touch(const GPoint a0, const GPoint a1, const GPoint b0, const GPoint b1) {
+    const int o1 = orientation(a0, a1, b0);
+    const int o2 = orientation(a0, a1, b1);
+    const int o3 = orientation(b0, b1, a0);
+    const int o4 = orientation(b0, b1, a1);
+    if (o1 != o2 && o3 != o4) return true;
+    return (o1 == 0 && on_segment(a0, a1, b0)) || (o2 == 0 && on_segment(a0, a1, b1)) ||
+           (o3 == 0 && on_segment(b0, b1, a0)) || (o4 == 0 && on_segment(b0, b1, a1));
+}
+
+/** A segment touches a rectangle if an end point is inside (edges included) or it touches an edge. */
+static bool reference_line_rect(const GPoint p0, const GPoint p1, const GPoint rect0, const GPoint rect1) {
+    const GPoint top_right = GPoint(rect1.x, rect0.y);
+    const GPoint bottom_left = GPoint(rect0.x, rect1.y);
+    return on_segment(rect0, rect1, p0) || on_segment(rect0, rect1, p1) ||
+           segments_touch(p0, p1, rect0, top_right) || segments_touch(p0, p1, rect0, bottom_left) ||
+           segments_touch(p0, p1, rect1, top_right) || segments_touch(p0, p1, rect1, bottom_left);
+}
+
+////////////////////////////////////////////
+//// Benchmark
+////////////////////////////////////////////
+
+/**
+ * The best time of several passes over all candidates, in nanoseconds per candidate; hits is the number of
+ * rectangles that touch a hand.
+ */
+static double time_candidates(bool old, const Candidate *candidates, int count, int passes, int *hits) {
+    uint64_t best = UINT64_MAX;
+    for (int pass = 0; pass < passes; pass++) {
+        int result = 0;
+        const uint64_t start = host_now_ns();
+        for (int i = 0; i < count; i++) {
+            const Candidate *c = &candidates[i];
+            if (old) {
+                result += old_line2_rect_intersect(center, c->hour_hand, center, c->minute_hand, c->rect0, c->rect1);
+            } else {
+                result += line2_rect_intersect(center, c->hour_hand, center, c->minute_hand, c->rect0, c->rect1);
+            }
+        }
+        const uint64_t ns = host_now_ns() - start;
+        if (ns < best) best = ns;
+        *hits = result;
+    }
+    return (double) best / count;
+}
+
+int main(int argc, char **argv) {
+    int passes = 5;
+    int step = 8;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--step") == 0 && i + 1 < argc) {
+            step = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--passes N] [--step S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (passes <= 0) passes = 1;
+    if (step <= 0) step = 1;
+
+    const GRect bounds = GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+    center = grect_center_point(&bounds);
+    width = bounds.size.w;
+    height = bounds.size.h;
+    config_square = false;
+    update_geometry(bounds);
+
+    // rectangles with their top left corner on a grid a bit larger than the screen
+    const int columns = (PBL_DISPLAY_WIDTH + 40) / step + 1;
+    const int rows = (PBL_DISPLAY_HEIGHT + 40) / step + 1;
+    const int count = 720 * (int) ARRAY_LENGTH(rect_sizes) * columns * rows;
+    Candidate *candidates = malloc(count * sizeof(Candidate));
+    if (!candidates) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    int n = 0;
+    for (int minute = 0; minute < 720; minute++) {
+        const GeometryOffset hour = geometry->hour_hand[minute / 10][0];
+        const GeometryOffset min = geometry->minute_hand[minute % 60][0];
+        const GPoint hour_hand = GPoint(center.x + hour.x, center.y + hour.y);
+        const GPoint minute_hand = GPoint(center.x + min.x, center.y + min.y);
+        for (size_t s = 0; s < ARRAY_LENGTH(rect_sizes); s++) {
+            for (int row = 0; row < rows; row++) {
+                for (int column = 0; column < columns; column++) {
+                    const GPoint rect0 = GPoint(column * step - 20 - rect_sizes[s].w / 2, row * step - 20);
+                    candidates[n++] = (Candidate) {
+                            .hour_hand = hour_hand,
+                            .minute_hand = minute_hand,
+                            .rect0 = rect0,
+                            .rect1 = GPoint(rect0.x + rect_sizes[s].w, rect0.y + rect_sizes[s].h),
+                    };
+                }
+            }
+        }
+    }
+
+    // compare both implementations with the reference
+    int new_wrong = 0, old_wrong = 0, old_contained = 0;
+    for (int i = 0; i < count; i++) {
+        const Candidate *c = &candidates[i];
+        const bool expected = reference_line_rect(center, c->hour_hand, c->rect0, c->rect1) ||
+                              reference_line_rect(center, c->minute_hand, c->rect0, c->rect1);
+        const bool now = line2_rect_intersect(center, c->hour_hand, center, c->minute_hand, c->rect0, c->rect1);
+        const bool before = old_line2_rect_intersect(center, c->hour_hand, center, c->minute_hand, c->rect0,
+                                                     c->rect1);
+        if (now != expected) {
+            if (new_wrong < 5) {
+                fprintf(stderr, "wrong: hands %d,%d and %d,%d, rectangle %d,%d-%d,%d: %d instead of %d\n",
+                        c->hour_hand.x, c->hour_hand.y, c->minute_hand.x, c->minute_hand.y, c->rect0.x, c->rect0.y,
+                        c->rect1.x, c->rect1.y, now, expected);
+            }
+            new_wrong += 1;
+        }
+        if (before != expected) {
+            old_wrong += 1;
+            // a hand completely inside the rectangle crosses none of its edges
+            if (on_segment(c->rect0, c->rect1, center) && (on_segment(c->rect0, c->rect1, c->hour_hand) ||
+                                                           on_segment(c->rect0, c->rect1, c->minute_hand))) {
+                old_contained += 1;
+            }
+        }
+    }
+
+    int old_hits, new_hits;
+    const double old_ns = time_candidates(true, candidates, count, passes, &old_hits);
+    const double new_ns = time_candidates(false, candidates, count, passes, &new_hits);
+    free(candidates);
+
+    printf("%s (%dx%d): %d candidates (720 hand positions, %d rectangle sizes, %d pixel grid)\n",
+           OBSIDIAN_HOST_PLATFORM, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT, count, (int) ARRAY_LENGTH(rect_sizes), step);
+    printf("%-10s %12s %8s %8s\n", "", "ns/candidate", "hits", "wrong");
+    printf("%-10s %12.2f %7.1f%% %8d (%d with a hand inside the rectangle)\n", "edges", old_ns,
+           100.0 * old_hits / count, old_wrong, old_contained);
+    printf("%-10s %12.2f %7.1f%% %8d\n", "outcodes", new_ns, 100.0 * new_hits / count, new_wrong);
+    printf("speedup: %.2fx\n", old_ns / new_ns);
+    if (new_wrong != 0) {
+        fprintf(stderr, "error: line2_rect_intersect disagrees with the reference for %d candidates\n", new_wrong);
+        return 1;
+    }
+    return 0;
+}
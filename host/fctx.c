@@ -0,0 +1,502 @@
+// Copyright 2015-16 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host implementation of the pebble-fctx subset used by Obsidian: .ffont
+// parsing, path flattening and a supersampling scan converter.
+
+#define OBSIDIAN_HOST_NO_ALLOC_WRAP
+#include "host.h"
+
+#define RASTER_INITIAL_EDGES 512
+#define QUADRATIC_SEGMENTS 6
+
+
+////////////////////////////////////////////
+//// Fonts
+////////////////////////////////////////////
+
+static FGlyphRange *font_ranges(FFont *font) {
+    return (FGlyphRange *) (font + 1);
+}
+
+static FGlyph *font_glyphs(FFont *font) {
+    return (FGlyph *) (font_ranges(font) + font->glyph_range_count);
+}
+
+FFont *ffont_create_from_resource(uint32_t resource_id) {
+    size_t size;
+    const uint8_t *data = host_resource_data(resource_id, &size);
+    FFont *font = host_malloc(size);
+    memcpy(font, data, size);
+    return font;
+}
+
+void ffont_destroy(FFont *font) {
+    host_free(font);
+}
+
+FGlyph *ffont_glyph_info(FFont *font, uint16_t unicode) {
+    uint16_t index = 0;
+    FGlyphRange *ranges = font_ranges(font);
+    for (uint16_t i = 0; i < font->glyph_range_count; i++) {
+        if (unicode >= ranges[i].begin && unicode < ranges[i].end) {
+            return &font_glyphs(font)[index + unicode - ranges[i].begin];
+        }
+        index += ranges[i].end - ranges[i].begin;
+    }
+    return NULL;
+}
+
+void *ffont_glyph_outline(FFont *font, FGlyph *glyph) {
+    uint8_t *path_data = (uint8_t *) (font_glyphs(font) + font->glyph_count);
+    return path_data + glyph->path_data_offset;
+}
+
+/** Decodes one UTF-8 code point and advances the string. */
+static uint16_t next_code_point(const char **text) {
+    const uint8_t *s = (const uint8_t *) *text;
+    uint16_t c = s[0];
+    if (c >= 0xE0 && s[1] && s[2]) {
+        c = (uint16_t) (((c & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F));
+        *text += 3;
+    } else if (c >= 0xC0 && s[1]) {
+        c = (uint16_t) (((c & 0x1F) << 6) | (s[1] & 0x3F));
+        *text += 2;
+    } else {
+        *text += 1;
+    }
+    return c;
+}
+
+/** Advance of the text in font units. */
+static int32_t text_advance(FFont *font, const char *text) {
+    int32_t advance = 0;
+    while (*text) {
+        FGlyph *glyph = ffont_glyph_info(font, next_code_point(&text));
+        if (glyph) advance += glyph->horiz_adv_x;
+    }
+    return advance;
+}
+
+
+////////////////////////////////////////////
+//// Scan conversion
+////////////////////////////////////////////
+
+void host_raster_add_edge(HostRaster *raster, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    if (y0 == y1) return;
+    if (raster->edge_count == raster->edge_capacity) {
+        raster->edge_capacity *= 2;
+        raster->edges = host_realloc(raster->edges, raster->edge_capacity * sizeof(HostEdge));
+    }
+    HostEdge *edge = &raster->edges[raster->edge_count++];
+    if (y0 < y1) {
+        *edge = (HostEdge) {x0, y0, x1, y1, 1};
+    } else {
+        *edge = (HostEdge) {x1, y1, x0, y0, -1};
+    }
+}
+
+typedef struct {
+    int32_t x;
+    int8_t dir;
+} Crossing;
+
+/**
+ * Fills the edge list with the non-zero winding rule.  Every pixel is sampled on a 4x4 grid, which gives 17
+ * coverage levels that are blended into the framebuffer.
+ */
+void host_raster_fill(GContext *ctx, HostRaster *raster, GColor color, bool antialiased) {
+    if (raster->edge_count == 0) return;
+    host_stats.draw_calls += 1;
+
+    int32_t min_x = INT32_MAX, max_x = INT32_MIN, min_y = INT32_MAX, max_y = INT32_MIN;
+    for (uint32_t i = 0; i < raster->edge_count; i++) {
+        const HostEdge *e = &raster->edges[i];
+        if (e->x0 < min_x) min_x = e->x0;
+        if (e->x1 < min_x) min_x = e->x1;
+        if (e->x0 > max_x) max_x = e->x0;
+        if (e->x1 > max_x) max_x = e->x1;
+        if (e->y0 < min_y) min_y = e->y0;
+        if (e->y1 > max_y) max_y = e->y1;
+    }
+
+    // restrict to the clip rectangle (in layer coordinates)
+    int32_t px0 = (min_x >> FIXED_POINT_SHIFT), px1 = (max_x >> FIXED_POINT_SHIFT) + 1;
+    int32_t py0 = (min_y >> FIXED_POINT_SHIFT), py1 = (max_y >> FIXED_POINT_SHIFT) + 1;
+    const int32_t cx0 = ctx->clip.origin.x - ctx->offset.x, cy0 = ctx->clip.origin.y - ctx->offset.y;
+    const int32_t cx1 = cx0 + ctx->clip.size.w, cy1 = cy0 + ctx->clip.size.h;
+    if (px0 < cx0) px0 = cx0;
+    if (py0 < cy0) py0 = cy0;
+    if (px1 > cx1) px1 = cx1;
+    if (py1 > cy1) py1 = cy1;
+    if (px0 >= px1 || py0 >= py1) return;
+
+    const int32_t span = px1 - px0;
+    uint8_t coverage[span];
+    Crossing crossings[raster->edge_count];
+
+    for (int32_t py = py0; py < py1; py++) {
+        memset(coverage, 0, (size_t) span);
+        bool any = false;
+        for (int32_t sy = 0; sy < 4; sy++) {
+            const int32_t y = INT_TO_FIXED(py) + sy * 4 + 2;
+            uint32_t n = 0;
+            for (uint32_t i = 0; i < raster->edge_count; i++) {
+                const HostEdge *e = &raster->edges[i];
+                if (y < e->y0 || y >= e->y1) continue;
+                crossings[n].x = e->x0 + (int32_t) ((int64_t) (y - e->y0) * (e->x1 - e->x0) / (e->y1 - e->y0));
+                crossings[n].dir = e->dir;
+                n++;
+            }
+            for (uint32_t i = 1; i < n; i++) {
+                for (uint32_t j = i; j > 0 && crossings[j - 1].x > crossings[j].x; j--) {
+                    Crossing tmp = crossings[j];
+                    crossings[j] = crossings[j - 1];
+                    crossings[j - 1] = tmp;
+                }
+            }
+            int32_t winding = 0;
+            for (uint32_t i = 0; i + 1 < n; i++) {
+                winding += crossings[i].dir;
+                if (winding == 0) continue;
+                // sample columns are at 4k + 2 (in 1/16 pixels); count those in [xa, xb)
+                int32_t first = (crossings[i].x - 2 + 3) >> 2;
+                int32_t last = ((crossings[i + 1].x - 2 + 3) >> 2) - 1;
+                if (first < px0 * 4) first = px0 * 4;
+                if (last > px1 * 4 - 1) last = px1 * 4 - 1;
+                for (int32_t s = first; s <= last; s++) {
+                    coverage[(s >> 2) - px0] += 1;
+                    any = true;
+                }
+            }
+        }
+        if (!any) continue;
+        for (int32_t i = 0; i < span; i++) {
+            if (coverage[i] == 0) continue;
+            host_blend_pixel(ctx, (int16_t) (px0 + i), (int16_t) py,
+                             color, antialiased ? coverage[i] : (uint8_t) (coverage[i] >= 8 ? 16 : 0));
+        }
+    }
+}
+
+
+////////////////////////////////////////////
+//// Text outlines
+////////////////////////////////////////////
+
+/** Maps font units to fixed point pixels: scale, flip the y axis, then translate. */
+typedef struct {
+    int32_t em_pixels;
+    int32_t units_per_em;
+    fixed_t x;
+    fixed_t y;
+    int32_t rotation;
+} GlyphTransform;
+
+static FPoint glyph_point(const GlyphTransform *t, int32_t pen_x, int32_t gx, int32_t gy) {
+    int32_t x = (int32_t) ((int64_t) (pen_x + gx) * INT_TO_FIXED(t->em_pixels) / t->units_per_em);
+    int32_t y = (int32_t) (-(int64_t) gy * INT_TO_FIXED(t->em_pixels) / t->units_per_em);
+    if (t->rotation) {
+        const int32_t s = sin_lookup(t->rotation), c = cos_lookup(t->rotation);
+        int32_t rx = (x * c - y * s) / TRIG_MAX_RATIO;
+        int32_t ry = (x * s + y * c) / TRIG_MAX_RATIO;
+        x = rx;
+        y = ry;
+    }
+    return FPoint(x + t->x, y + t->y);
+}
+
+/** Walks the outline of one glyph, flattening quadratic curves into line segments. */
+static void glyph_edges(FFont *font, FGlyph *glyph, const GlyphTransform *t, int32_t pen_x,
+                        HostRaster *raster) {
+    const int16_t *p = ffont_glyph_outline(font, glyph);
+    const int16_t *end = (const int16_t *) ((const uint8_t *) p + glyph->path_data_length);
+    int32_t init_x = 0, init_y = 0, cur_x = 0, cur_y = 0, ctrl_x = 0, ctrl_y = 0;
+    FPoint init = glyph_point(t, pen_x, 0, 0), cur = init;
+    while (p < end) {
+        const uint16_t cmd = (uint16_t) *p++;
+        int32_t x = cur_x, y = cur_y;
+        switch (cmd) {
+            case 'M':
+                if (cur.x != init.x || cur.y != init.y) {
+                    host_raster_add_edge(raster, cur.x, cur.y, init.x, init.y);
+                }
+                cur_x = init_x = p[0];
+                cur_y = init_y = p[1];
+                ctrl_x = cur_x;
+                ctrl_y = cur_y;
+                cur = init = glyph_point(t, pen_x, cur_x, cur_y);
+                p += 2;
+                continue;
+            case 'L':
+                x = p[0];
+                y = p[1];
+                p += 2;
+                break;
+            case 'H':
+                x = p[0];
+                p += 1;
+                break;
+            case 'V':
+                y = p[0];
+                p += 1;
+                break;
+            case 'Z':
+                x = init_x;
+                y = init_y;
+                break;
+            case 'Q':
+            case 'T': {
+                int32_t qx, qy;
+                if (cmd == 'Q') {
+                    qx = p[0];
+                    qy = p[1];
+                    x = p[2];
+                    y = p[3];
+                    p += 4;
+                } else {
+                    qx = 2 * cur_x - ctrl_x;
+                    qy = 2 * cur_y - ctrl_y;
+                    x = p[0];
+                    y = p[1];
+                    p += 2;
+                }
+                for (int32_t i = 1; i < QUADRATIC_SEGMENTS; i++) {
+                    const int32_t a = QUADRATIC_SEGMENTS - i, n2 = QUADRATIC_SEGMENTS * QUADRATIC_SEGMENTS;
+                    int32_t bx = (a * a * cur_x + 2 * a * i * qx + i * i * x) / n2;
+                    int32_t by = (a * a * cur_y + 2 * a * i * qy + i * i * y) / n2;
+                    FPoint next = glyph_point(t, pen_x, bx, by);
+                    host_raster_add_edge(raster, cur.x, cur.y, next.x, next.y);
+                    cur = next;
+                }
+                FPoint next = glyph_point(t, pen_x, x, y);
+                host_raster_add_edge(raster, cur.x, cur.y, next.x, next.y);
+                cur = next;
+                cur_x = x;
+                cur_y = y;
+                ctrl_x = qx;
+                ctrl_y = qy;
+                continue;
+            }
+            default:
+                // unknown command, the rest of the outline cannot be interpreted
+                p = end;
+                continue;
+        }
+        FPoint next = glyph_point(t, pen_x, x, y);
+        host_raster_add_edge(raster, cur.x, cur.y, next.x, next.y);
+        cur = next;
+        cur_x = ctrl_x = x;
+        cur_y = ctrl_y = y;
+    }
+    if (cur.x != init.x || cur.y != init.y) {
+        host_raster_add_edge(raster, cur.x, cur.y, init.x, init.y);
+    }
+}
+
+static void text_edges(FFont *font, const char *text, const GlyphTransform *t, HostRaster *raster) {
+    int32_t pen_x = 0;
+    while (*text) {
+        FGlyph *glyph = ffont_glyph_info(font, next_code_point(&text));
+        if (glyph == NULL) continue;
+        glyph_edges(font, glyph, t, pen_x, raster);
+        pen_x += glyph->horiz_adv_x;
+    }
+}
+
+static HostRaster text_raster;
+
+fixed_t host_text_width(FFont *font, int16_t size, const char *text) {
+    return (fixed_t) ((int64_t) text_advance(font, text) * INT_TO_FIXED(size) / font->units_per_em);
+}
+
+/** Draws text for the bitmap font stand-ins; (x, y) is the left end of the cap line. */
+void host_draw_text(GContext *ctx, FFont *font, int16_t size, int16_t x, int16_t y, const char *text, GColor color) {
+    if (text_raster.edges == NULL) {
+        text_raster.edge_capacity = RASTER_INITIAL_EDGES;
+        text_raster.edges = host_malloc(text_raster.edge_capacity * sizeof(HostEdge));
+    }
+    GlyphTransform t = {
+            .em_pixels = size,
+            .units_per_em = font->units_per_em,
+            .x = INT_TO_FIXED(x),
+            .y = INT_TO_FIXED(y) + (fixed_t) ((int64_t) font->cap_height * INT_TO_FIXED(size) / font->units_per_em),
+            .rotation = 0,
+    };
+    text_raster.edge_count = 0;
+    text_edges(font, text, &t, &text_raster);
+    // the system fonts are drawn without anti-aliasing
+    host_raster_fill(ctx, &text_raster, color, false);
+    host_stats.draw_calls -= 1;
+}
+
+
+////////////////////////////////////////////
+//// FContext
+////////////////////////////////////////////
+
+static HostRaster fctx_raster(FContext *fctx) {
+    return (HostRaster) {fctx->edges, fctx->edge_count, fctx->edge_capacity, fctx->coverage};
+}
+
+static void fctx_store_raster(FContext *fctx, const HostRaster *raster) {
+    fctx->edges = raster->edges;
+    fctx->edge_count = raster->edge_count;
+    fctx->edge_capacity = raster->edge_capacity;
+}
+
+void fctx_init_context(FContext *fctx, GContext *gctx) {
+    memset(fctx, 0, sizeof(FContext));
+    fctx->gctx = gctx;
+    fctx->transform_scale_from = FPointOne;
+    fctx->transform_scale_to = FPointOne;
+    fctx->fill_color = GColorBlack;
+    fctx->edge_capacity = RASTER_INITIAL_EDGES;
+    fctx->edges = host_malloc(fctx->edge_capacity * sizeof(HostEdge));
+    // the real library keeps a coverage row for the whole display
+    fctx->coverage = host_malloc(PBL_DISPLAY_WIDTH * sizeof(uint8_t));
+}
+
+void fctx_deinit_context(FContext *fctx) {
+    host_free(fctx->edges);
+    host_free(fctx->coverage);
+    fctx->edges = NULL;
+    fctx->coverage = NULL;
+}
+
+void fctx_set_fill_color(FContext *fctx, GColor c) {
+    fctx->fill_color = c;
+}
+
+void fctx_set_color_bias(FContext *fctx, int16_t bias) {
+    fctx->color_bias = bias;
+}
+
+void fctx_set_offset(FContext *fctx, FPoint offset) {
+    fctx->transform_offset = offset;
+}
+
+void fctx_set_pivot(FContext *fctx, FPoint pivot) {
+    fctx->transform_pivot = pivot;
+}
+
+void fctx_set_scale(FContext *fctx, FPoint scale_from, FPoint scale_to) {
+    fctx->transform_scale_from = scale_from;
+    fctx->transform_scale_to = scale_to;
+}
+
+void fctx_set_rotation(FContext *fctx, uint32_t rotation) {
+    fctx->transform_rotation = (int32_t) rotation;
+}
+
+static FPoint fctx_transform(FContext *fctx, FPoint p) {
+    int32_t x = (int32_t) ((int64_t) (p.x - fctx->transform_pivot.x) * fctx->transform_scale_to.x /
+                           fctx->transform_scale_from.x);
+    int32_t y = (int32_t) ((int64_t) (p.y - fctx->transform_pivot.y) * fctx->transform_scale_to.y /
+                           fctx->transform_scale_from.y);
+    if (fctx->transform_rotation) {
+        const int32_t s = sin_lookup(fctx->transform_rotation), c = cos_lookup(fctx->transform_rotation);
+        int32_t rx = (x * c - y * s) / TRIG_MAX_RATIO;
+        int32_t ry = (x * s + y * c) / TRIG_MAX_RATIO;
+        x = rx;
+        y = ry;
+    }
+    return FPoint(x + fctx->transform_offset.x, y + fctx->transform_offset.y);
+}
+
+void fctx_begin_fill(FContext *fctx) {
+    fctx->edge_count = 0;
+    fctx->path_init_point = FPointZero;
+    fctx->path_cur_point = FPointZero;
+}
+
+void fctx_move_to(FContext *fctx, FPoint p) {
+    fctx_close_path(fctx);
+    fctx->path_init_point = fctx->path_cur_point = fctx_transform(fctx, p);
+}
+
+void fctx_line_to(FContext *fctx, FPoint p) {
+    FPoint next = fctx_transform(fctx, p);
+    HostRaster raster = fctx_raster(fctx);
+    host_raster_add_edge(&raster, fctx->path_cur_point.x, fctx->path_cur_point.y, next.x, next.y);
+    fctx_store_raster(fctx, &raster);
+    fctx->path_cur_point = next;
+}
+
+void fctx_close_path(FContext *fctx) {
+    if (fctx->path_cur_point.x == fctx->path_init_point.x && fctx->path_cur_point.y == fctx->path_init_point.y) {
+        return;
+    }
+    HostRaster raster = fctx_raster(fctx);
+    host_raster_add_edge(&raster, fctx->path_cur_point.x, fctx->path_cur_point.y,
+                         fctx->path_init_point.x, fctx->path_init_point.y);
+    fctx_store_raster(fctx, &raster);
+    fctx->path_cur_point = fctx->path_init_point;
+}
+
+void fctx_end_fill(FContext *fctx) {
+    fctx_close_path(fctx);
+    HostRaster raster = fctx_raster(fctx);
+    host_raster_fill(fctx->gctx, &raster, fctx->fill_color, true);
+    fctx->edge_count = 0;
+}
+
+void fctx_set_text_em_height(FContext *fctx, FFont *font, int16_t pixels) {
+    fctx->transform_scale_from = FPoint(font->units_per_em, font->units_per_em);
+    fctx->transform_scale_to = FPoint(pixels, pixels);
+}
+
+fixed_t fctx_string_width(FContext *fctx, const char *text, FFont *font) {
+    return (fixed_t) ((int64_t) text_advance(font, text) * INT_TO_FIXED(fctx->transform_scale_to.x) /
+                      fctx->transform_scale_from.x);
+}
+
+void fctx_draw_string(FContext *fctx, const char *text, FFont *font, GTextAlignment alignment, FTextAnchor anchor) {
+    const int32_t advance = text_advance(font, text);
+    int32_t dx = 0;
+    if (alignment == GTextAlignmentCenter) dx = -advance / 2;
+    if (alignment == GTextAlignmentRight) dx = -advance;
+    int32_t dy = 0;
+    switch (anchor) {
+        case FTextAnchorBaseline:
+            break;
+        case FTextAnchorMiddle:
+            dy = (font->ascent + font->descent) / 2;
+            break;
+        case FTextAnchorCapMiddle:
+            dy = font->cap_height / 2;
+            break;
+        case FTextAnchorTop:
+            dy = font->ascent;
+            break;
+        case FTextAnchorCapTop:
+            dy = font->cap_height;
+            break;
+        case FTextAnchorBottom:
+            dy = font->descent;
+            break;
+    }
+    const int32_t em = fctx->transform_scale_to.x, upem = fctx->transform_scale_from.x;
+    GlyphTransform t = {
+            .em_pixels = em,
+            .units_per_em = upem,
+            .x = fctx->transform_offset.x + (fixed_t) ((int64_t) dx * INT_TO_FIXED(em) / upem),
+            .y = fctx->transform_offset.y + (fixed_t) ((int64_t) dy * INT_TO_FIXED(em) / upem),
+            .rotation = fctx->transform_rotation,
+    };
+    HostRaster raster = fctx_raster(fctx);
+    text_edges(font, text, &t, &raster);
+    fctx_store_raster(fctx, &raster);
+}
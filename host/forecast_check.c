@@ -0,0 +1,140 @@
+// Copyright 2015-16 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Forecast expiry check: plays back an hourly forecast with a weather
+// expiration below one hour, and checks that every entry is shown for the
+// whole hour it is for, and that the weather expires config_weather_expiration
+// minutes after the last entry (or after a weather message) is over.  It also
+// checks that the watch only drops the forecast for a configuration that comes
+// with MSG_KEY_WEATHER_INVALID.  Exits with an error if any check fails.
+//
+// usage: obsidian-forecast-check-<platform>
+
+#include "host.h"
+#include "../src/obsidian.h"
+#include "../src/drawing.h"
+
+void init();
+void deinit();
+
+// Monday, 17 October 2016, 10:00 UTC
+#define CHECK_HOUR 1476698400
+#define CHECK_EXPIRATION 30
+#define CHECK_HOURS 3
+
+static int failures;
+
+/** Go to the given number of seconds after CHECK_HOUR, and let the watchface see the tick. */
+static void go_to(time_t offset) {
+    host_set_time(CHECK_HOUR + offset);
+    host_tick(SECOND_UNIT | MINUTE_UNIT | HOUR_UNIT);
+    host_advance_ms(0);
+}
+
+/** Check whether the weather is shown, and with what temperature. */
+static void expect(const char *what, bool visible, int8_t temperature) {
+    const bool shown = weather_is_visible();
+    if (shown != visible || (visible && weather.temperature != temperature)) {
+        fprintf(stderr, "%s: %s: weather %s with %d instead of %s with %d\n", OBSIDIAN_HOST_PLATFORM, what,
+                shown ? "shown" : "not shown", weather.temperature, visible ? "shown" : "not shown", temperature);
+        failures += 1;
+    }
+}
+
+/** Send a forecast for CHECK_HOURS hours from start, with temperatures counting up from temperature. */
+static void send_forecast(uint32_t start, int8_t temperature) {
+    uint8_t data[4 + 1 + 2 * CHECK_HOURS];
+    data[0] = (uint8_t) start;
+    data[1] = (uint8_t) (start >> 8);
+    data[2] = (uint8_t) (start >> 16);
+    data[3] = (uint8_t) (start >> 24);
+    data[4] = CHECK_HOURS;
+    for (int i = 0; i < CHECK_HOURS; i++) {
+        data[5 + 2 * i] = 1;
+        data[5 + 2 * i + 1] = (uint8_t) (temperature + i);
+    }
+    DictionaryIterator *iter = host_message_begin();
+    dict_write_data(iter, MSG_KEY_FORECAST, data, sizeof(data));
+    host_message_deliver();
+    host_advance_ms(0);
+}
+
+/** Send a new weather color, with MSG_KEY_WEATHER_INVALID if invalid is set, and check the forecast is kept or not. */
+static void send_config(uint8_t color, bool invalid) {
+    DictionaryIterator *iter = host_message_begin();
+    dict_write_uint8(iter, CONFIG_COLOR_WEATHER, color);
+    if (invalid) {
+        dict_write_uint8(iter, MSG_KEY_WEATHER_INVALID, 1);
+    }
+    host_message_deliver();
+    host_advance_ms(0);
+    if ((forecast.count == 0) != invalid) {
+        fprintf(stderr, "%s: configuration %s MSG_KEY_WEATHER_INVALID: forecast of %d hours\n", OBSIDIAN_HOST_PLATFORM,
+                invalid ? "with" : "without", forecast.count);
+        failures += 1;
+    }
+}
+
+int main(int argc, char **argv) {
+    host_persist_reset();
+    go_to(50 * SECONDS_PER_MINUTE);
+    init();
+    host_render();
+    host_advance_ms(0);
+
+    DictionaryIterator *iter = host_message_begin();
+    dict_write_uint16(iter, CONFIG_WEATHER_EXPIRATION, CHECK_EXPIRATION);
+    host_message_deliver();
+    host_advance_ms(0);
+
+    // a forecast for 10:00 to 12:59, received at 10:50, with the hour as temperature
+    send_forecast(CHECK_HOUR, 10);
+    expect("forecast received at 10:50", true, 10);
+    go_to(59 * SECONDS_PER_MINUTE + 59);
+    expect("end of the first hour", true, 10);
+    go_to(SECONDS_PER_HOUR);
+    expect("start of the second hour", true, 11);
+    go_to(SECONDS_PER_HOUR + 45 * SECONDS_PER_MINUTE);
+    expect("second hour, 10:45 past it", true, 11);
+    go_to(2 * SECONDS_PER_HOUR + 59 * SECONDS_PER_MINUTE);
+    expect("end of the last hour", true, 12);
+    go_to(3 * SECONDS_PER_HOUR + CHECK_EXPIRATION * SECONDS_PER_MINUTE);
+    expect("expiration after the last hour", true, 12);
+    go_to(3 * SECONDS_PER_HOUR + (CHECK_EXPIRATION + 1) * SECONDS_PER_MINUTE);
+    expect("past the expiration after the last hour", false, 0);
+
+    // a weather message expires config_weather_expiration minutes after it is received
+    iter = host_message_begin();
+    dict_write_int8(iter, MSG_KEY_WEATHER_ICON, 1);
+    dict_write_int8(iter, MSG_KEY_WEATHER_TEMP, 20);
+    host_message_deliver();
+    host_advance_ms(0);
+    go_to(3 * SECONDS_PER_HOUR + (2 * CHECK_EXPIRATION + 1) * SECONDS_PER_MINUTE);
+    expect("weather message at its expiration", true, 20);
+    go_to(3 * SECONDS_PER_HOUR + (2 * CHECK_EXPIRATION + 2) * SECONDS_PER_MINUTE);
+    expect("weather message past its expiration", false, 0);
+
+    // only a configuration with other weather settings drops the forecast
+    send_forecast(CHECK_HOUR + 4 * SECONDS_PER_HOUR, 14);
+    send_config(GColorRedARGB8, false);
+    send_config(GColorBlueARGB8, true);
+
+    deinit();
+    if (failures > 0) {
+        fprintf(stderr, "error: %d forecast checks failed\n", failures);
+        return 1;
+    }
+    printf("%s: forecast checks passed\n", OBSIDIAN_HOST_PLATFORM);
+    return 0;
+}
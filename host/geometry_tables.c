@@ -0,0 +1,97 @@
+// Copyright 2015-16 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Geometry table generator: computes the end points of the ticks and hands for
+// the whole screen of a platform with compute_geometry (src/geometry.c), and
+// writes them as the constant tables that src/geometry.c includes, so the watch
+// does not compute them at runtime.  Round watches only have the circle; the
+// others also get the square.  The host trigonometry rounds the exact values,
+// like the lookup tables of the SDK; OBSIDIAN_GEOMETRY_CHECK (src/obsidian.h)
+// makes the watch log any point where they disagree.
+//
+// usage: obsidian-geometry-<platform> <output.h>
+
+#include <stdio.h>
+#include "host.h"
+#include "../src/geometry.h"
+
+GPoint center;
+int16_t height;
+int16_t width;
+uint8_t config_square;
+
+/**
+ * Write the n pairs of points of one part of the geometry.
+ */
+static void write_points(FILE *out, const char *name, const GeometryOffset (*points)[2], int n) {
+    fprintf(out, "        .%s = {\n", name);
+    for (int i = 0; i < n; i++) {
+        fprintf(out, "%s{{%d, %d}, {%d, %d}},", i % 4 == 0 ? "                " : " ",
+                points[i][0].x, points[i][0].y, points[i][1].x, points[i][1].y);
+        if (i % 4 == 3 || i == n - 1) {
+            fprintf(out, "\n");
+        }
+    }
+    fprintf(out, "        },\n");
+}
+
+/**
+ * Compute and write the geometry of the whole screen, as a circle or a square.
+ */
+static void write_geometry(FILE *out, const char *name, bool square) {
+    GRect bounds = GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+    center = grect_center_point(&bounds);
+    width = bounds.size.w;
+    height = bounds.size.h;
+    config_square = square;
+    Geometry result;
+    compute_geometry(&result);
+
+    fprintf(out, "\nstatic const Geometry %s = {\n", name);
+    write_points(out, "hour_ticks", result.hour_ticks, 12);
+    write_points(out, "minute_ticks", result.minute_ticks, 60);
+    write_points(out, "minute_hand", result.minute_hand, 60);
+    write_points(out, "hour_hand", result.hour_hand, 12 * 6);
+    fprintf(out, "};\n");
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <output.h>\n", argv[0]);
+        return 2;
+    }
+    FILE *out = fopen(argv[1], "w");
+    if (!out) {
+        perror(argv[1]);
+        return 1;
+    }
+    fprintf(out, "// Generated by host/geometry_tables.c for %s (%dx%d), do not edit.\n"
+                 "// Regenerate with: cmake --build <build-dir> --target geometry_tables\n\n",
+            OBSIDIAN_HOST_PLATFORM, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+#ifdef OBSIDIAN_LONG_TICKS
+    fprintf(out, "#define GEOMETRY_TABLES_LONG_TICKS 1\n");
+#else
+    fprintf(out, "#define GEOMETRY_TABLES_LONG_TICKS 0\n");
+#endif
+    write_geometry(out, "geometry_circle", false);
+#ifndef PBL_ROUND
+    write_geometry(out, "geometry_square", true);
+#endif
+    if (fclose(out) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    printf("%s: geometry for %dx%d\n", argv[1], PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+    return 0;
+}
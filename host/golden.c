@@ -0,0 +1,434 @@
+// Copyright 2015-16 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Golden-image renderer: renders the screenshot scenarios of the Makefile
+// (the SCREENSHOT_* configurations of src/obsidian.h, reproduced at runtime
+// through the simulated clock, services and configuration messages) and a
+// sweep over all date formats and times.  Every image is written as a PNG and
+// compared pixel by pixel with the golden image in host/golden/<platform>;
+// mismatches also get a -diff.png with the differing pixels in red.  Every
+// scenario is rendered in its own forked process (a fresh watchface), up to
+// --jobs at a time.  With --update, the golden images are written instead.
+//
+// usage: obsidian-golden-<platform> [--update] [--jobs N] [--out DIR] [--only NAME]
+
+#define OBSIDIAN_HOST_NO_ALLOC_WRAP
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "host.h"
+#include "../src/obsidian.h"
+
+void init();
+void deinit();
+
+// Saturday, 8 May 2021, 10:10 UTC (the "nice" date and time of the screenshots)
+#define GOLDEN_NICE_TIME 1620468600
+#define GOLDEN_FORMATS 18
+#define GOLDEN_MAX_CONFIG 16
+
+#define BLUETOOTH_CONNECTED 0
+#define BLUETOOTH_DISCONNECTED 1
+#define BLUETOOTH_POPUP_CONNECTED 2
+#define BLUETOOTH_POPUP_DISCONNECTED 3
+
+#define RESULT_MATCH 0
+#define RESULT_MISMATCH 1
+#define RESULT_MISSING 2
+#define RESULT_ERROR 3
+
+typedef struct {
+    uint8_t key;
+    uint8_t value;
+} ConfigValue;
+
+/** One image: the time, the configuration sent to the watchface, and the state of the simulated watch. */
+typedef struct {
+    const char *name;
+    time_t time;
+    bool color_only;
+    ConfigValue config[GOLDEN_MAX_CONFIG];
+    char weather_icon;
+    int8_t temperature;
+    uint8_t battery;
+    uint8_t bluetooth;
+} Scenario;
+
+// the configuration of the alternative themes is in init() in src/obsidian.c
+#define THEME_1_2(accent) \
+        {CONFIG_COLOR_DAY_OF_WEEK, accent}, {CONFIG_COLOR_HOUR_HAND, accent}, {CONFIG_COLOR_WEATHER, GColorBlackARGB8}
+#define THEME(hour_ticks, minute_ticks, outer, inner, minute, hour, circle, ticks, day, date, inner_minute, inner_hour) \
+        {CONFIG_HOUR_TICKS, hour_ticks}, {CONFIG_MINUTE_TICKS, minute_ticks}, \
+        {CONFIG_COLOR_OUTER_BACKGROUND, outer}, {CONFIG_COLOR_INNER_BACKGROUND, inner}, \
+        {CONFIG_COLOR_MINUTE_HAND, minute}, {CONFIG_COLOR_HOUR_HAND, hour}, {CONFIG_COLOR_CIRCLE, circle}, \
+        {CONFIG_COLOR_TICKS, ticks}, {CONFIG_COLOR_DAY_OF_WEEK, day}, {CONFIG_COLOR_DATE, date}, \
+        {CONFIG_BATTERY_LOGO, 3}, {CONFIG_COLOR_INNER_MINUTE_HAND, inner_minute}, \
+        {CONFIG_COLOR_INNER_HOUR_HAND, inner_hour}, {CONFIG_COLOR_WEATHER, date}
+
+/** The screenshots of the Makefile (see the SCREENSHOT_* configurations in src/obsidian.h). */
+static const Scenario screenshots[] = {
+        {"main", GOLDEN_NICE_TIME, false, {{0}}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"square", GOLDEN_NICE_TIME, false, {{CONFIG_SQUARE, 1}}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"battery-low-1", GOLDEN_NICE_TIME, false, {{0}}, 'a', 74, 30, BLUETOOTH_CONNECTED},
+        {"battery-low-2", GOLDEN_NICE_TIME, false, {{0}}, 'a', 74, 20, BLUETOOTH_CONNECTED},
+        {"battery-low-3", GOLDEN_NICE_TIME, false, {{0}}, 'a', 74, 10, BLUETOOTH_CONNECTED},
+        {"date-1", GOLDEN_NICE_TIME + 16 * SECONDS_PER_MINUTE, false, {{0}}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"date-2", GOLDEN_NICE_TIME - 10 * SECONDS_PER_HOUR + 21 * SECONDS_PER_MINUTE, false, {{0}}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"weather-1", GOLDEN_NICE_TIME, false, {{0}}, 'B', 59, 0, BLUETOOTH_CONNECTED},
+        {"weather-2", GOLDEN_NICE_TIME, false, {{0}}, 'h', -12, 0, BLUETOOTH_CONNECTED},
+        {"bluetooth-icon", GOLDEN_NICE_TIME, false, {{0}}, 'a', 74, 0, BLUETOOTH_DISCONNECTED},
+        {"bluetooth-popup-1", GOLDEN_NICE_TIME, false, {{0}}, 'a', 74, 0, BLUETOOTH_POPUP_CONNECTED},
+        {"bluetooth-popup-2", GOLDEN_NICE_TIME, false, {{0}}, 'a', 74, 0, BLUETOOTH_POPUP_DISCONNECTED},
+        {"theme-1", GOLDEN_NICE_TIME, true, {THEME_1_2(GColorRedARGB8)}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"theme-2", GOLDEN_NICE_TIME, true, {THEME_1_2(GColorBlueARGB8)}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"theme-3", GOLDEN_NICE_TIME, true,
+                {THEME(3, 3, GColorPurpleARGB8, GColorPurpleARGB8, GColorBlackARGB8, GColorBlackARGB8,
+                       GColorBlackARGB8, GColorBlackARGB8, GColorPurpleARGB8, GColorPurpleARGB8, GColorBlackARGB8,
+                       GColorBlackARGB8)}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"theme-4", GOLDEN_NICE_TIME, true,
+                {THEME(1, 1, GColorBlackARGB8, GColorBlackARGB8, GColorWhiteARGB8, GColorBabyBlueEyesARGB8,
+                       GColorBlackARGB8, GColorBlackARGB8, GColorBabyBlueEyesARGB8, GColorWhiteARGB8,
+                       GColorLightGrayARGB8, GColorLightGrayARGB8)}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"theme-5", GOLDEN_NICE_TIME, true,
+                {THEME(3, 3, GColorVividCeruleanARGB8, GColorVividCeruleanARGB8, GColorChromeYellowARGB8,
+                       GColorChromeYellowARGB8, GColorVividCeruleanARGB8, GColorChromeYellowARGB8,
+                       GColorVividCeruleanARGB8, GColorVividCeruleanARGB8, GColorChromeYellowARGB8,
+                       GColorChromeYellowARGB8)}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"theme-6", GOLDEN_NICE_TIME, true,
+                {THEME(1, 2, GColorWhiteARGB8, GColorWhiteARGB8, GColorRedARGB8, GColorBlackARGB8, GColorBlackARGB8,
+                       GColorBlackARGB8, GColorWhiteARGB8, GColorWhiteARGB8, GColorRedARGB8, GColorBlackARGB8)},
+                'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"theme-7", GOLDEN_NICE_TIME, true,
+                {THEME(1, 2, GColorWhiteARGB8, GColorWhiteARGB8, GColorBlackARGB8, GColorBlackARGB8,
+                       GColorBlackARGB8, GColorBlackARGB8, GColorWhiteARGB8, GColorBlackARGB8, GColorBlackARGB8,
+                       GColorBlackARGB8)}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"theme-8", GOLDEN_NICE_TIME, true,
+                {THEME(1, 2, GColorWhiteARGB8, GColorIcterineARGB8, GColorBlueARGB8, GColorBlackARGB8,
+                       GColorBlackARGB8, GColorBlackARGB8, GColorIcterineARGB8, GColorBlueARGB8, GColorBlueARGB8,
+                       GColorBlackARGB8)}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+        {"seconds", GOLDEN_NICE_TIME + 37, false, {{CONFIG_SECONDS, 1}}, 'a', 74, 0, BLUETOOTH_CONNECTED},
+};
+
+/** The sweep: every date format, on a different day and at a different time (the hands cover the whole dial). */
+static Scenario formats[GOLDEN_FORMATS];
+static char format_names[GOLDEN_FORMATS][16];
+
+static const char *golden_dir = OBSIDIAN_HOST_GOLDEN "/" OBSIDIAN_HOST_PLATFORM;
+static char out_dir[512] = "golden-out/" OBSIDIAN_HOST_PLATFORM;
+static bool update;
+
+
+////////////////////////////////////////////
+//// PNG files (8-bit palette of the 64 Pebble colors, no filters)
+////////////////////////////////////////////
+
+#define PNG_COLORS 64
+
+static void png_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t size) {
+    const uint8_t header[8] = {size >> 24, size >> 16, size >> 8, size, type[0], type[1], type[2], type[3]};
+    fwrite(header, 1, 8, f);
+    if (size) fwrite(data, 1, size, f);
+    uLong crc = crc32(crc32(0, header + 4, 4), data, size);
+    const uint8_t footer[4] = {crc >> 24, crc >> 16, crc >> 8, crc};
+    fwrite(footer, 1, 4, f);
+}
+
+/**
+ * Writes an image given as indices into the Pebble colors (the lower six bits of the ARGB8 color).
+ */
+static bool png_write(const char *path, const uint8_t *pixels, int w, int h) {
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) return false;
+    fwrite("\x89PNG\r\n\x1a\n", 1, 8, f);
+    const uint8_t ihdr[13] = {w >> 24, w >> 16, w >> 8, w, h >> 24, h >> 16, h >> 8, h, 8, 3, 0, 0, 0};
+    png_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    uint8_t palette[PNG_COLORS * 3];
+    for (int i = 0; i < PNG_COLORS; i++) {
+        palette[i * 3] = (uint8_t) (((i >> 4) & 3) * 85);
+        palette[i * 3 + 1] = (uint8_t) (((i >> 2) & 3) * 85);
+        palette[i * 3 + 2] = (uint8_t) ((i & 3) * 85);
+    }
+    png_chunk(f, "PLTE", palette, sizeof(palette));
+    // every row starts with its filter type (none)
+    const uLong raw_size = (uLong) (w + 1) * h;
+    uint8_t *raw = malloc(raw_size);
+    for (int y = 0; y < h; y++) {
+        raw[y * (w + 1)] = 0;
+        memcpy(raw + y * (w + 1) + 1, pixels + y * w, (size_t) w);
+    }
+    uLongf size = compressBound(raw_size);
+    uint8_t *data = malloc(size);
+    compress2(data, &size, raw, raw_size, Z_BEST_COMPRESSION);
+    png_chunk(f, "IDAT", data, (uint32_t) size);
+    png_chunk(f, "IEND", NULL, 0);
+    free(raw);
+    free(data);
+    return fclose(f) == 0;
+}
+
+static uint32_t read_u32(const uint8_t *p) {
+    return (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 8 | p[3];
+}
+
+/**
+ * Reads an image written by png_write (of the given size) into pixels.  Returns false if the file is missing or
+ * not in that format.
+ */
+static bool png_read(const char *path, uint8_t *pixels, int w, int h) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return false;
+    fseek(f, 0, SEEK_END);
+    const long file_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *file = malloc((size_t) file_size);
+    const bool read = fread(file, 1, (size_t) file_size, f) == (size_t) file_size;
+    fclose(f);
+
+    bool ok = read && file_size > 8 && memcmp(file, "\x89PNG\r\n\x1a\n", 8) == 0;
+    uint8_t *idat = malloc((size_t) file_size);
+    uLong idat_size = 0;
+    for (long offset = 8; ok && offset + 12 <= file_size;) {
+        const uint32_t size = read_u32(file + offset);
+        const uint8_t *type = file + offset + 4;
+        const uint8_t *data = file + offset + 8;
+        if (offset + 12 + (long) size > file_size) {
+            ok = false;
+        } else if (memcmp(type, "IHDR", 4) == 0) {
+            ok = size == 13 && read_u32(data) == (uint32_t) w && read_u32(data + 4) == (uint32_t) h &&
+                 data[8] == 8 && data[9] == 3;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            memcpy(idat + idat_size, data, size);
+            idat_size += size;
+        }
+        offset += 12 + size;
+    }
+
+    uLongf raw_size = (uLongf) (w + 1) * h;
+    uint8_t *raw = malloc(raw_size);
+    ok = ok && uncompress(raw, &raw_size, idat, idat_size) == Z_OK && raw_size == (uLongf) (w + 1) * h;
+    for (int y = 0; ok && y < h; y++) {
+        ok = raw[y * (w + 1)] == 0;
+        memcpy(pixels + y * w, raw + y * (w + 1) + 1, (size_t) w);
+    }
+    free(raw);
+    free(idat);
+    free(file);
+    return ok;
+}
+
+
+////////////////////////////////////////////
+//// Rendering
+////////////////////////////////////////////
+
+static void send_config(uint8_t key, uint8_t value) {
+    DictionaryIterator *iter = host_message_begin();
+    dict_write_uint8(iter, key, value);
+    host_message_deliver();
+    host_advance_ms(0);
+}
+
+/**
+ * Launches the watchface and brings it into the state of the scenario.
+ */
+static void render(const Scenario *scenario) {
+    host_set_time(scenario->time);
+    host_set_battery(scenario->battery ? scenario->battery : 80, false, false);
+    host_set_bluetooth(true);
+    init();
+    host_render();
+    host_advance_ms(0);
+
+    // one value per message, the inbox is too small for a whole theme
+    for (int i = 0; i < GOLDEN_MAX_CONFIG && scenario->config[i].key != 0; i++) {
+        send_config(scenario->config[i].key, scenario->config[i].value);
+    }
+    if (scenario->weather_icon) {
+        DictionaryIterator *iter = host_message_begin();
+        dict_write_int8(iter, MSG_KEY_WEATHER_ICON, scenario->weather_icon);
+        dict_write_int8(iter, MSG_KEY_WEATHER_TEMP, scenario->temperature);
+        host_message_deliver();
+        host_advance_ms(0);
+    }
+    switch (scenario->bluetooth) {
+        case BLUETOOTH_DISCONNECTED:
+            // wait for the popup to go away
+            host_set_bluetooth(false);
+            host_advance_ms(OBSIDIAN_BLUETOOTH_POPUP_MS);
+            break;
+        case BLUETOOTH_POPUP_CONNECTED:
+            host_set_bluetooth(false);
+            host_advance_ms(OBSIDIAN_BLUETOOTH_POPUP_MS);
+            host_set_bluetooth(true);
+            break;
+        case BLUETOOTH_POPUP_DISCONNECTED:
+            host_set_bluetooth(false);
+            break;
+    }
+    host_render();
+}
+
+static void image_path(char *path, size_t size, const char *dir, const char *name, const char *suffix) {
+    snprintf(path, size, "%s/%s%s.png", dir, name, suffix);
+}
+
+/**
+ * Renders one scenario and writes or compares its image (in a forked process).  Returns a RESULT_*.
+ */
+static int run_scenario(const Scenario *scenario) {
+    render(scenario);
+    const int w = PBL_DISPLAY_WIDTH;
+    const int h = PBL_DISPLAY_HEIGHT;
+    uint8_t *actual = malloc((size_t) w * h);
+    uint8_t *golden = malloc((size_t) w * h);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            actual[y * w + x] = (uint8_t) (host_framebuffer_pixel((int16_t) x, (int16_t) y).argb & 0x3f);
+        }
+    }
+    deinit();
+
+    char path[1024];
+    if (update) {
+        image_path(path, sizeof(path), golden_dir, scenario->name, "");
+        if (!png_write(path, actual, w, h)) {
+            fprintf(stderr, "cannot write %s\n", path);
+            return RESULT_ERROR;
+        }
+        return RESULT_MATCH;
+    }
+
+    image_path(path, sizeof(path), out_dir, scenario->name, "");
+    if (!png_write(path, actual, w, h)) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return RESULT_ERROR;
+    }
+    image_path(path, sizeof(path), golden_dir, scenario->name, "");
+    if (!png_read(path, golden, w, h)) {
+        printf("%s: no golden image %s\n", scenario->name, path);
+        return RESULT_MISSING;
+    }
+    int differences = 0;
+    for (int i = 0; i < w * h; i++) {
+        if (actual[i] != golden[i]) {
+            differences += 1;
+            golden[i] = GColorRedARGB8 & 0x3f;
+        } else {
+            golden[i] = GColorWhiteARGB8 & 0x3f;
+        }
+    }
+    if (differences == 0) return RESULT_MATCH;
+    image_path(path, sizeof(path), out_dir, scenario->name, "-diff");
+    png_write(path, golden, w, h);
+    printf("%s: %d pixels differ (see %s)\n", scenario->name, differences, path);
+    return RESULT_MISMATCH;
+}
+
+static bool make_dirs(char *path) {
+    for (char *p = path + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = 0;
+        const bool ok = mkdir(path, 0755) == 0 || errno == EEXIST;
+        *p = '/';
+        if (!ok) return false;
+    }
+    return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+
+int main(int argc, char **argv) {
+    int jobs = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    const char *only = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            snprintf(out_dir, sizeof(out_dir), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--update] [--jobs N] [--out DIR] [--only NAME]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (jobs <= 0) jobs = 1;
+
+    // make the output independent of the machine
+    setenv("TZ", "UTC", 1);
+    setenv("LC_ALL", "C", 1);
+    tzset();
+
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", update ? golden_dir : out_dir);
+    if (!make_dirs(dir)) {
+        fprintf(stderr, "cannot create %s\n", dir);
+        return 2;
+    }
+
+    const Scenario *scenarios[ARRAY_LENGTH(screenshots) + GOLDEN_FORMATS];
+    int count = 0;
+    for (unsigned i = 0; i < ARRAY_LENGTH(screenshots); i++) {
+        if (screenshots[i].color_only && !PBL_IF_COLOR_ELSE(true, false)) continue;
+        scenarios[count++] = &screenshots[i];
+    }
+    for (int f = 0; f < GOLDEN_FORMATS; f++) {
+        snprintf(format_names[f], sizeof(format_names[f]), "format-%02d", f);
+        formats[f] = (Scenario) {format_names[f], GOLDEN_NICE_TIME + f * (SECONDS_PER_DAY + 97 * SECONDS_PER_MINUTE),
+                                 false, {{CONFIG_DATE_FORMAT, (uint8_t) f}}, 'a', 74, 0, BLUETOOTH_CONNECTED};
+        scenarios[count++] = &formats[f];
+    }
+
+    // every scenario gets a fresh process, so that no state of the watchface carries over
+    const uint64_t start = host_now_ns();
+    int results[4] = {0};
+    int images = 0;
+    int running = 0;
+    for (int i = 0; i <= count; i++) {
+        while (running > 0 && (running == jobs || i == count)) {
+            int status;
+            if (wait(&status) < 0) break;
+            running -= 1;
+            results[WIFEXITED(status) && WEXITSTATUS(status) <= RESULT_ERROR ? WEXITSTATUS(status) : RESULT_ERROR]++;
+        }
+        if (i == count) break;
+        if (only != NULL && strcmp(scenarios[i]->name, only) != 0) continue;
+        fflush(stdout);
+        const pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return 2;
+        }
+        if (pid == 0) {
+            const int result = run_scenario(scenarios[i]);
+            fflush(stdout);
+            _exit(result);
+        }
+        running += 1;
+        images += 1;
+    }
+
+    printf("%s: %d images %s in %.2f s (%d jobs)", OBSIDIAN_HOST_PLATFORM, images,
+           update ? "written" : "compared", (host_now_ns() - start) / 1e9, jobs);
+    if (!update) {
+        printf(", %d mismatches, %d without golden image", results[RESULT_MISMATCH], results[RESULT_MISSING]);
+    }
+    printf("\n");
+    if (results[RESULT_ERROR] > 0) {
+        fprintf(stderr, "error: %d images failed\n", results[RESULT_ERROR]);
+    }
+    return results[RESULT_MATCH] == images ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+// Copyright 2015-16 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Host-only API to drive the simulated watch (clock, services, messages,
+// rendering) and to read back statistics.  Not visible to the watchface.
+
+#ifndef OBSIDIAN_HOST_HOST_H
+#define OBSIDIAN_HOST_HOST_H
+
+#include <pebble.h>
+#include <pebble-fctx/fctx.h>
+
+////////////////////////////////////////////
+//// Simulated environment
+////////////////////////////////////////////
+
+void host_set_time(time_t t);
+void host_advance_ms(uint32_t ms);
+void host_tick(TimeUnits units_changed);
+void host_set_battery(uint8_t charge_percent, bool is_charging, bool is_plugged);
+void host_set_bluetooth(bool connected);
+void host_set_quiet_time(bool active);
+void host_set_unobstructed_height(int16_t height);
+
+/** Renders the window if any of its layers is dirty; returns true if a frame was drawn. */
+bool host_render(void);
+GBitmap *host_framebuffer(void);
+GColor host_framebuffer_pixel(int16_t x, int16_t y);
+
+/** Starts a message from the phone; deliver it to the watchface with host_message_deliver. */
+DictionaryIterator *host_message_begin(void);
+bool host_message_deliver(void);
+
+void host_persist_reset(void);
+
+
+////////////////////////////////////////////
+//// Statistics
+////////////////////////////////////////////
+
+typedef struct {
+    uint64_t frames;
+    uint64_t draw_calls;
+    uint64_t allocations;
+    uint64_t persist_reads;
+    uint64_t persist_writes;
+    uint64_t messages_sent;
+    uint64_t bytes_sent;
+    uint64_t messages_received;
+    uint64_t bytes_received;
+    uint32_t inbox_size;
+    uint32_t outbox_size;
+} HostStats;
+
+extern HostStats host_stats;
+
+#define HOST_MAX_STAGES 16
+
+/** Time and draw calls spent in one PROFILE_STAGE of the update procedures. */
+typedef struct {
+    const char *name;
+    uint64_t ns;
+    uint64_t draw_calls;
+} HostStage;
+
+extern HostStage host_stages[HOST_MAX_STAGES];
+extern int host_stage_count;
+
+/** Time spent in each STARTUP_PHASE of the last launch (since host_startup_reset), in order. */
+extern HostStage host_startup_phases[HOST_MAX_STAGES];
+extern int host_startup_phase_count;
+
+void host_profile_reset(void);
+void host_startup_reset(void);
+uint64_t host_now_ns(void);
+
+
+////////////////////////////////////////////
+//// Internals shared by host/pebble.c and host/fctx.c
+////////////////////////////////////////////
+
+struct GBitmap {
+    GBitmapFormat format;
+    uint8_t *data;
+    uint16_t bytes_per_row;
+    GRect bounds;
+    const uint16_t *row_offset;
+    const int16_t *row_min_x;
+    const int16_t *row_max_x;
+    bool owns_data;
+};
+
+struct GContext {
+    GBitmap *framebuffer;
+    GRect clip;
+    GPoint offset;
+    GColor stroke_color;
+    GColor fill_color;
+    GColor text_color;
+    uint8_t stroke_width;
+    bool antialiased;
+    bool captured;
+};
+
+struct HostFont {
+    FFont *ffont;
+    int16_t size;
+    bool system;
+};
+
+typedef struct HostEdge {
+    int32_t x0;
+    int32_t y0;
+    int32_t x1;
+    int32_t y1;
+    int8_t dir;
+} HostEdge;
+
+/** Edge list and scratch buffers of the scan converter. */
+typedef struct {
+    HostEdge *edges;
+    uint32_t edge_count;
+    uint32_t edge_capacity;
+    uint8_t *coverage;
+} HostRaster;
+
+void host_blend_pixel(GContext *ctx, int16_t x, int16_t y, GColor color, uint8_t coverage);
+void host_raster_fill(GContext *ctx, HostRaster *raster, GColor color, bool antialiased);
+void host_raster_add_edge(HostRaster *raster, int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+void host_draw_text(GContext *ctx, FFont *font, int16_t size, int16_t x, int16_t y, const char *text, GColor color);
+fixed_t host_text_width(FFont *font, int16_t size, const char *text);
+const uint8_t *host_resource_data(uint32_t resource_id, size_t *size);
+
+#endif //OBSIDIAN_HOST_HOST_H
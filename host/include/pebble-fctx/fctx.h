@@ -0,0 +1,89 @@
+// Copyright 2015-16 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Stand-in for pebble-fctx/fctx.h.  Only the subset of the API used by
+// Obsidian is provided; fills are scan-converted with 4x4 supersampling into
+// the host framebuffer (see host/fctx.c).
+
+#ifndef OBSIDIAN_HOST_FCTX_H
+#define OBSIDIAN_HOST_FCTX_H
+
+#include <pebble.h>
+#include "ffont.h"
+
+typedef int32_t fixed_t;
+
+#define FIXED_POINT_SHIFT 4
+#define FIXED_POINT_SCALE 16
+#define INT_TO_FIXED(a) ((a) * FIXED_POINT_SCALE)
+#define FIXED_TO_INT(a) ((a) / FIXED_POINT_SCALE)
+#define FIXED_MUL(a, b) (((a) * (b)) / FIXED_POINT_SCALE)
+
+typedef struct FPoint {
+    fixed_t x;
+    fixed_t y;
+} FPoint;
+#define FPoint(x, y) ((FPoint){(x), (y)})
+#define FPointZero FPoint(0, 0)
+#define FPointOne FPoint(FIXED_POINT_SCALE, FIXED_POINT_SCALE)
+
+typedef enum {
+    FTextAnchorBaseline,
+    FTextAnchorMiddle,
+    FTextAnchorCapMiddle,
+    FTextAnchorTop,
+    FTextAnchorCapTop,
+    FTextAnchorBottom,
+} FTextAnchor;
+
+struct HostEdge;
+
+typedef struct FContext {
+    GContext *gctx;
+    FPoint transform_offset;
+    FPoint transform_pivot;
+    FPoint transform_scale_from;
+    FPoint transform_scale_to;
+    int32_t transform_rotation;
+    GColor fill_color;
+    int16_t color_bias;
+    FPoint path_init_point;
+    FPoint path_cur_point;
+    struct HostEdge *edges;
+    uint32_t edge_count;
+    uint32_t edge_capacity;
+    uint8_t *coverage;
+} FContext;
+
+void fctx_init_context(FContext *fctx, GContext *gctx);
+void fctx_deinit_context(FContext *fctx);
+
+void fctx_set_fill_color(FContext *fctx, GColor c);
+void fctx_set_color_bias(FContext *fctx, int16_t bias);
+void fctx_set_offset(FContext *fctx, FPoint offset);
+void fctx_set_pivot(FContext *fctx, FPoint pivot);
+void fctx_set_scale(FContext *fctx, FPoint scale_from, FPoint scale_to);
+void fctx_set_rotation(FContext *fctx, uint32_t rotation);
+
+void fctx_begin_fill(FContext *fctx);
+void fctx_move_to(FContext *fctx, FPoint p);
+void fctx_line_to(FContext *fctx, FPoint p);
+void fctx_close_path(FContext *fctx);
+void fctx_end_fill(FContext *fctx);
+
+void fctx_set_text_em_height(FContext *fctx, FFont *font, int16_t pixels);
+fixed_t fctx_string_width(FContext *fctx, const char *text, FFont *font);
+void fctx_draw_string(FContext *fctx, const char *text, FFont *font, GTextAlignment alignment, FTextAnchor anchor);
+
+#endif //OBSIDIAN_HOST_FCTX_H
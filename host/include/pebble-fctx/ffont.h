@@ -0,0 +1,50 @@
+// Copyright 2015-16 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Stand-in for pebble-fctx/ffont.h.  The font layout matches the .ffont files
+// produced by pebble-fctx-compiler, so the real resources can be loaded.
+
+#ifndef OBSIDIAN_HOST_FFONT_H
+#define OBSIDIAN_HOST_FFONT_H
+
+#include <pebble.h>
+
+typedef int16_t fixed16_t;
+
+typedef struct __attribute__((__packed__)) FGlyphRange {
+    uint16_t begin;
+    uint16_t end;
+} FGlyphRange;
+
+typedef struct __attribute__((__packed__)) FGlyph {
+    uint16_t path_data_offset;
+    uint16_t path_data_length;
+    fixed16_t horiz_adv_x;
+} FGlyph;
+
+typedef struct __attribute__((__packed__)) FFont {
+    fixed16_t units_per_em;
+    fixed16_t ascent;
+    fixed16_t descent;
+    fixed16_t cap_height;
+    uint16_t glyph_range_count;
+    uint16_t glyph_count;
+} FFont;
+
+FFont *ffont_create_from_resource(uint32_t resource_id);
+void ffont_destroy(FFont *font);
+FGlyph *ffont_glyph_info(FFont *font, uint16_t unicode);
+void *ffont_glyph_outline(FFont *font, FGlyph *glyph);
+
+#endif //OBSIDIAN_HOST_FFONT_H
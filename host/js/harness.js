@@ -0,0 +1,510 @@
+// PebbleKit JS harness: runs src/js/pebble-js-app.js in Node, against stand-ins for the Pebble JS environment
+// (Pebble, localStorage, XMLHttpRequest, navigator.geolocation) and the fake weather server (weather-server.js).
+// For every provider and weather mode it measures the weather refreshes: the time from the watch asking for the
+// weather (MSG_KEY_FETCH_WEATHER) until the answer is sent, the HTTP requests and bytes, and the app messages sent
+// to the watch.  The phone clock is set to the time the responses were recorded (and runs in UTC).  Without
+// injected errors or timeouts, the harness fails if a refresh does not end with weather information.  With
+// --time-scale S, the phone clock and its timers (e.g. the 30 second request timeout) and the server latency run S
+// times faster; the latencies are reported in phone time.  The refreshes of a provider and mode run on the same phone
+// (so later ones may be answered from the weather cache), with --cold every refresh runs on a new phone.  With
+// --nack-rate P, the watch does not acknowledge that fraction of the app messages.
+//
+// usage: node host/js/harness.js [--runs N] [--provider NAME] [--mode M] [--latency MS] [--error-rate P]
+//                                [--timeout-rate P] [--geolocation-ms MS] [--location LAT,LON] [--time-scale S]
+//                                [--nack-rate P] [--seed N] [--cold] [--verbose]
+
+process.env.TZ = "UTC";
+
+var fs = require('fs');
+var http = require('http');
+var path = require('path');
+var vm = require('vm');
+var weatherServer = require('./weather-server');
+
+var APP_SOURCE = path.join(__dirname, '..', '..', 'src', 'js', 'pebble-js-app.js');
+
+// Friday, 14 July 2017, 10:20 UTC (when the responses in host/js/recordings were recorded)
+var RECORDED_TIME = 1500027600000;
+var RECORDED_LOCATION = {latitude: 47.37, longitude: 8.54};
+
+var SOURCES = [["openweathermap", 1], ["darksky", 2], ["wunderground", 3]];
+var MODES = [["current", 1], ["daily", 2], ["mode 3", 3]];
+
+/** Messages that end a weather refresh. */
+var ANSWER_KEYS = ["MSG_KEY_FORECAST", "MSG_KEY_WEATHER_ICON", "MSG_KEY_WEATHER_FAILED"];
+
+function now() {
+    var t = process.hrtime();
+    return t[0] * 1000 + t[1] / 1e6;
+}
+
+/** Size of an app message on the wire: the dictionary header, and a header of 7 bytes and the value per tuple. */
+function messageBytes(data) {
+    var bytes = 1;
+    for (var key in data) {
+        var value = data[key];
+        if (Array.isArray(value)) {
+            bytes += 7 + value.length;
+        } else if (typeof value === "string") {
+            bytes += 7 + Buffer.byteLength(value) + 1;
+        } else {
+            bytes += 7 + 4;
+        }
+    }
+    return bytes;
+}
+
+/** Deterministic random numbers in [0, 1), for the injected errors. */
+function makeRandom(seed) {
+    var state = seed >>> 0;
+    return function () {
+        state = (state * 1664525 + 1013904223) >>> 0;
+        return state / 4294967296;
+    };
+}
+
+/**
+ * A phone running the PebbleKit JS app: the app source is evaluated in a fresh context with the given configuration
+ * in localStorage (an empty one, or the given storage of an earlier phone).  Requests to the weather providers go to
+ * the fake server on the given port.
+ */
+function createPhone(config, options, storage) {
+    var scale = options.timeScale;
+    var handlers = {};
+    storage = storage || {};
+    // pending counts what the app still waits for: timers, requests, positions and message acknowledgements
+    var phone = {messages: [], requests: 0, bytes: 0, logs: [], pending: 0, storage: storage};
+    var timers = new Set();
+    for (var key in config) {
+        storage[key] = String(config[key]);
+    }
+
+    // the clock starts at the recording time and runs time-scale times faster
+    var realStart = Date.now();
+    var clock = function () {
+        return RECORDED_TIME + (Date.now() - realStart) * scale;
+    };
+    class PhoneDate extends Date {
+        constructor() {
+            if (arguments.length === 0) {
+                super(clock());
+            } else {
+                super(...arguments);
+            }
+        }
+        static now() {
+            return clock();
+        }
+    }
+
+    function XMLHttpRequest() {
+        this.readyState = 0;
+        this.status = 0;
+        this.statusText = "";
+        this.responseText = "";
+        this.onload = null;
+    }
+    XMLHttpRequest.prototype.open = function (method, address) {
+        this.method = method;
+        this.address = address;
+        this.readyState = 1;
+    };
+    XMLHttpRequest.prototype.send = function () {
+        var xhr = this;
+        var target = new URL(this.address);
+        phone.requests += 1;
+        phone.pending += 1;
+        this.done = false;
+        this.request = http.request({
+            host: "127.0.0.1",
+            port: options.port,
+            method: this.method,
+            path: "/" + target.host + target.pathname + target.search
+        }, function (res) {
+            var chunks = [];
+            res.on("data", function (chunk) {
+                chunks.push(chunk);
+            });
+            res.on("end", function () {
+                if (xhr.done) return;
+                xhr.done = true;
+                phone.pending -= 1;
+                var body = Buffer.concat(chunks);
+                phone.bytes += body.length;
+                xhr.readyState = 4;
+                xhr.status = res.statusCode;
+                xhr.statusText = http.STATUS_CODES[res.statusCode];
+                xhr.responseText = body.toString("utf8");
+                if (xhr.onload) xhr.onload();
+            });
+        });
+        // aborted requests are not answered
+        this.request.on("error", function () {
+        });
+        this.request.end();
+    };
+    XMLHttpRequest.prototype.abort = function () {
+        this.onload = null;
+        if (this.request && !this.done) {
+            this.done = true;
+            phone.pending -= 1;
+        }
+        if (this.request) this.request.destroy();
+    };
+
+    var context = {
+        Pebble: {
+            addEventListener: function (name, handler) {
+                (handlers[name] = handlers[name] || []).push(handler);
+            },
+            sendAppMessage: function (data, success, failure) {
+                var acked = options.random() >= options.nackRate;
+                phone.messages.push({time: now(), data: data, bytes: messageBytes(data), acked: acked});
+                phone.pending += 1;
+                setImmediate(function () {
+                    phone.pending -= 1;
+                    if (acked) {
+                        if (success) success({data: data});
+                    } else if (failure) {
+                        failure({data: data, error: {message: "APP_MSG_BUSY"}});
+                    }
+                });
+            },
+            openURL: function (address) {
+            },
+            getActiveWatchInfo: function () {
+                return {platform: "basalt", model: "pebble_time_black", language: "en_US",
+                    firmware: {major: 4, minor: 3, patch: 0, suffix: ""}};
+            },
+            getWatchToken: function () {
+                return "0123456789abcdef";
+            },
+            getAccountToken: function () {
+                return "fedcba9876543210";
+            }
+        },
+        localStorage: {
+            getItem: function (key) {
+                return storage.hasOwnProperty(key) ? storage[key] : null;
+            },
+            setItem: function (key, value) {
+                storage[key] = String(value);
+            },
+            removeItem: function (key) {
+                delete storage[key];
+            },
+            clear: function () {
+                for (var key in storage) {
+                    delete storage[key];
+                }
+            }
+        },
+        navigator: {
+            geolocation: {
+                getCurrentPosition: function (success, failure, geoOptions) {
+                    phone.pending += 1;
+                    setTimeout(function () {
+                        phone.pending -= 1;
+                        success({coords: RECORDED_LOCATION, timestamp: clock()});
+                    }, options.geolocationMs / scale);
+                }
+            }
+        },
+        XMLHttpRequest: XMLHttpRequest,
+        Date: PhoneDate,
+        setTimeout: function (callback, delay) {
+            var args = [].slice.call(arguments, 2);
+            var timer = setTimeout(function () {
+                timers.delete(timer);
+                phone.pending -= 1;
+                callback.apply(null, args);
+            }, (delay || 0) / scale);
+            timers.add(timer);
+            phone.pending += 1;
+            return timer;
+        },
+        clearTimeout: function (timer) {
+            if (timers.delete(timer)) {
+                phone.pending -= 1;
+                clearTimeout(timer);
+            }
+        },
+        console: {
+            log: function () {
+                var line = [].slice.call(arguments).join(" ");
+                phone.logs.push(line);
+                if (options.verbose) console.log("    [js] " + line);
+            }
+        }
+    };
+    vm.createContext(context);
+    vm.runInContext(fs.readFileSync(APP_SOURCE, "utf8"), context, {filename: APP_SOURCE});
+
+    phone.emit = function (name, event) {
+        var list = handlers[name] || [];
+        for (var i = 0; i < list.length; i++) {
+            list[i](event);
+        }
+    };
+    return phone;
+}
+
+/** Resolves once the phone does not wait for anything anymore. */
+function settle(phone) {
+    return new Promise(function (resolve) {
+        var poll = setInterval(function () {
+            if (phone.pending == 0) {
+                clearInterval(poll);
+                resolve();
+            }
+        }, 1);
+    });
+}
+
+/**
+ * Asks the phone for the weather (as the watch does, with a watch that never received weather and refreshes every 30
+ * minutes) and waits for the answer (see measure).
+ */
+function refresh(phone, options) {
+    return measure(phone, options, function () {
+        phone.emit("appmessage", {payload: {"MSG_KEY_FETCH_WEATHER": 1, "MSG_KEY_WEATHER_STATE": [0, 0, 0, 0, 30, 0, 6]}});
+    });
+}
+
+/**
+ * Starts the app on the phone and waits for the weather it sends on its own (see measure).
+ */
+function startup(phone, options) {
+    return measure(phone, options, function () {
+        phone.emit("ready", {});
+    });
+}
+
+/**
+ * Triggers the phone and waits for the weather answer the watch acknowledges, or until the phone is done without
+ * sending one ("not sent", e.g. if the watch has recent weather at startup).  Resolves to the latency (in ms), the HTTP
+ * requests and bytes and the app messages (all attempts), and the answer.
+ */
+function measure(phone, options, trigger) {
+    var start = now();
+    var firstMessage = phone.messages.length;
+    var requests = phone.requests;
+    var bytes = phone.bytes;
+    return new Promise(function (resolve, reject) {
+        var deadline = setTimeout(function () {
+            clearInterval(poll);
+            reject(new Error("no weather answer within 60 seconds"));
+        }, 60000 / options.timeScale);
+        var done = function (end, data) {
+            clearTimeout(deadline);
+            clearInterval(poll);
+            var messages = phone.messages.slice(firstMessage, end);
+            resolve({
+                // in phone time
+                latency: ((end > firstMessage ? phone.messages[end - 1].time : now()) - start) * options.timeScale,
+                requests: phone.requests - requests,
+                bytes: phone.bytes - bytes,
+                messages: messages.length,
+                messageBytes: messages.reduce(function (sum, m) {
+                    return sum + m.bytes;
+                }, 0),
+                answer: data ? describeAnswer(data) : "not sent"
+            });
+        };
+        var poll = setInterval(function () {
+            for (var i = firstMessage; i < phone.messages.length; i++) {
+                var data = phone.messages[i].data;
+                if (!phone.messages[i].acked) continue;
+                for (var k = 0; k < ANSWER_KEYS.length; k++) {
+                    if (ANSWER_KEYS[k] in data) {
+                        done(i + 1, data);
+                        return;
+                    }
+                }
+            }
+            if (phone.pending == 0) {
+                done(phone.messages.length, null);
+            }
+        }, 1);
+        trigger();
+    });
+}
+
+/** Short description of a weather answer, e.g. "24h b 25" for a forecast starting with icon b and 25 degrees. */
+function describeAnswer(data) {
+    if ("MSG_KEY_FORECAST" in data) {
+        var bytes = data["MSG_KEY_FORECAST"];
+        return bytes[4] + "h " + String.fromCharCode(bytes[5]) + " " + (bytes[6] << 24 >> 24);
+    }
+    if ("MSG_KEY_WEATHER_ICON" in data) {
+        return String.fromCharCode(data["MSG_KEY_WEATHER_ICON"]) + " " + data["MSG_KEY_WEATHER_TEMP"];
+    }
+    return "failed";
+}
+
+function parseArguments(args) {
+    var options = {
+        runs: 5, provider: null, mode: null, latency: 0, errorRate: 0, timeoutRate: 0, geolocationMs: 0,
+        location: null, nackRate: 0, timeScale: 1, seed: 1, cold: false, verbose: false
+    };
+    for (var i = 0; i < args.length; i++) {
+        var arg = args[i];
+        if (arg == "--runs") options.runs = +args[++i];
+        else if (arg == "--provider") options.provider = args[++i];
+        else if (arg == "--mode") options.mode = +args[++i];
+        else if (arg == "--latency") options.latency = +args[++i];
+        else if (arg == "--error-rate") options.errorRate = +args[++i];
+        else if (arg == "--timeout-rate") options.timeoutRate = +args[++i];
+        else if (arg == "--geolocation-ms") options.geolocationMs = +args[++i];
+        else if (arg == "--location") options.location = args[++i];
+        else if (arg == "--time-scale") options.timeScale = +args[++i];
+        else if (arg == "--seed") options.seed = +args[++i];
+        else if (arg == "--nack-rate") options.nackRate = +args[++i];
+        else if (arg == "--cold") options.cold = true;
+        else if (arg == "--verbose") options.verbose = true;
+        else {
+            console.error("unknown argument: " + arg);
+            process.exit(2);
+        }
+    }
+    return options;
+}
+
+/**
+ * Prints a line of the results table, returns the number of results without the expected answer: "weather" or "none"
+ * ("not sent").
+ */
+function printResults(provider, label, results, expected) {
+    var total = function (field) {
+        return results.reduce(function (sum, result) {
+            return sum + result[field];
+        }, 0);
+    };
+    var answers = {};
+    var failures = 0;
+    results.forEach(function (result) {
+        answers[result.answer] = (answers[result.answer] || 0) + 1;
+        if (result.answer == "failed" || isNaN(result.latency)) {
+            failures += 1;
+        } else if ((result.answer == "not sent") != (expected == "none")) {
+            failures += 1;
+        }
+    });
+    var n = results.length;
+    console.log(provider + pad("", 16 - provider.length) + label + pad("", 8 - label.length) +
+        pad((total("latency") / n).toFixed(1), 12) + " / " +
+        pad(Math.max.apply(null, results.map(function (result) {
+            return result.latency;
+        })).toFixed(1), 8) +
+        pad((total("requests") / n).toFixed(1), 14) +
+        pad(Math.round(total("bytes") / n), 13) +
+        pad((total("messages") / n).toFixed(1), 7) +
+        pad(Math.round(total("messageBytes") / n), 12) + "   " +
+        Object.keys(answers).map(function (answer) {
+            return answers[answer] + "x " + answer;
+        }).join(", "));
+    return failures;
+}
+
+function pad(value, width) {
+    var text = String(value);
+    while (text.length < width) text = " " + text;
+    return text;
+}
+
+async function main() {
+    var options = parseArguments(process.argv.slice(2));
+    var server = weatherServer.createServer({
+        latency: options.latency / options.timeScale,
+        errorRate: options.errorRate,
+        timeoutRate: options.timeoutRate,
+        random: makeRandom(options.seed)
+    });
+    await new Promise(function (resolve) {
+        server.listen(0, "127.0.0.1", resolve);
+    });
+    options.port = server.address().port;
+    options.random = makeRandom(options.seed + 1);
+    var injected = options.errorRate > 0 || options.timeoutRate > 0;
+
+    console.log("weather refreshes (" + options.runs + " per provider and mode, latency " + options.latency +
+        " ms, errors " + options.errorRate + ", timeouts " + options.timeoutRate + ", nacks " +
+        options.nackRate + ")");
+    console.log("provider        mode      latency ms (mean / max)   http req   http bytes   msgs   msg bytes   answers");
+    var failures = 0;
+    var configs = [];
+    for (var s = 0; s < SOURCES.length; s++) {
+        if (options.provider && options.provider != SOURCES[s][0]) continue;
+        for (var m = 0; m < MODES.length; m++) {
+            if (options.mode && options.mode != MODES[m][1]) continue;
+            var config = {
+                "CONFIG_WEATHER_SOURCE_LOCAL": SOURCES[s][1],
+                "CONFIG_WEATHER_MODE_LOCAL": MODES[m][1],
+                "CONFIG_WEATHER_UNIT_LOCAL": 1,
+                "CONFIG_WEATHER_APIKEY_LOCAL": "recorded"
+            };
+            if (options.location) {
+                config["CONFIG_WEATHER_LOCATION_LOCAL"] = options.location;
+            }
+            configs.push([SOURCES[s][0], config]);
+            var phone = createPhone(config, options);
+            phone.emit("ready", {});
+            await settle(phone);
+
+            var results = [];
+            for (var r = 0; r < options.runs; r++) {
+                if (options.cold && r > 0) {
+                    phone = createPhone(config, options);
+                    phone.emit("ready", {});
+                    await settle(phone);
+                }
+                try {
+                    results.push(await refresh(phone, options));
+                } catch (e) {
+                    results.push({latency: NaN, requests: 0, bytes: 0, messages: 0, messageBytes: 0,
+                        answer: e.message});
+                }
+            }
+            failures += printResults(SOURCES[s][0], MODES[m][0], results, "weather");
+        }
+    }
+
+    // relaunches of the app: the watch has recent weather, or it needs new weather (which is in the phone's cache
+    // from an earlier refresh, or not)
+    console.log("");
+    console.log("startup (" + options.runs + " relaunches per provider and state)");
+    console.log("provider        state     latency ms (mean / max)   http req   http bytes   msgs   msg bytes   answers");
+    var watchWeather = function (received) {
+        return JSON.stringify({received: received, refresh: 30, forecastHours: 6, forecastStart: 0, forecastCount: 0});
+    };
+    for (var c = 0; c < configs.length; c++) {
+        if (c > 0 && configs[c][0] == configs[c - 1][0]) continue;
+        var states = [["fresh", RECORDED_TIME, false], ["due", 0, false], ["cached", 0, true]];
+        for (var t = 0; t < states.length; t++) {
+            var results = [];
+            for (var r = 0; r < options.runs; r++) {
+                var storage = {};
+                if (states[t][2]) {
+                    // an earlier session fetched the weather
+                    var earlier = createPhone(configs[c][1], options);
+                    await refresh(earlier, options);
+                    await settle(earlier);
+                    storage = earlier.storage;
+                }
+                storage["WATCH_WEATHER"] = watchWeather(states[t][1]);
+                var phone = createPhone(configs[c][1], options, storage);
+                results.push(await startup(phone, options));
+                await settle(phone);
+            }
+            failures += printResults(configs[c][0], states[t][0], results, states[t][0] == "fresh" ? "none" : "weather");
+        }
+    }
+    server.close();
+
+    if (failures > 0 && !injected) {
+        console.error("error: " + failures + " refreshes or startups did not end with the expected weather answer");
+        process.exit(1);
+    }
+}
+
+main();
@@ -0,0 +1,142 @@
+// Fake weather server: answers the requests of src/js/pebble-js-app.js from the recorded provider responses in
+// host/js/recordings, with configurable latency, errors and timeouts.  Requests are addressed as
+// http://127.0.0.1:<port>/<provider host>/<path>, the harness (host/js/harness.js) rewrites the URLs accordingly.
+//
+// usage: node host/js/weather-server.js [--port N] [--latency MS] [--error-rate P] [--timeout-rate P]
+
+var http = require('http');
+var fs = require('fs');
+var path = require('path');
+var url = require('url');
+
+var RECORDINGS = path.join(__dirname, 'recordings');
+
+/** Provider of every host the watchface talks to (the name of its recording). */
+var PROVIDERS = {
+    "api.openweathermap.org": "openweathermap",
+    "api.darksky.net": "darksky",
+    "api.wunderground.com": "wunderground"
+};
+
+/** Answers for each provider: the response body for a request (or null if there is none). */
+var RESPONDERS = {
+    // one recording per endpoint
+    "openweathermap": function (recording, pathname, query) {
+        return recording[pathname] || null;
+    },
+    // /forecast/<key>/<lat>,<lon>: one recording, without the blocks in "exclude"
+    "darksky": function (recording, pathname, query) {
+        if (pathname.indexOf("/forecast/") !== 0) return null;
+        var body = JSON.parse(JSON.stringify(recording.forecast));
+        var exclude = (query.exclude || "").split(",");
+        for (var i = 0; i < exclude.length; i++) {
+            delete body[exclude[i]];
+        }
+        return body;
+    },
+    // /api/<key>/<feature>/.../q/<location>.json: one recording per feature, combined
+    "wunderground": function (recording, pathname, query) {
+        var parts = pathname.split("/");
+        var q = parts.indexOf("q");
+        if (parts[1] != "api" || q < 0) return null;
+        var body = {"response": JSON.parse(JSON.stringify(recording.response))};
+        for (var i = 3; i < q; i++) {
+            var feature = parts[i];
+            if (!recording[feature]) return null;
+            body.response.features[feature] = 1;
+            for (var key in recording[feature]) {
+                body[key] = recording[feature][key];
+            }
+        }
+        return body;
+    }
+};
+
+/**
+ * Creates the server.  Options (all optional): latency (in ms, before every answer), errorRate and timeoutRate
+ * (fraction of requests answered with status 500, or not at all), random (a function returning numbers in [0, 1)).
+ * Every answered request is logged in server.requests as {provider, path, status, bytes}.
+ */
+function createServer(options) {
+    options = options || {};
+    var random = options.random || Math.random;
+    var recordings = {};
+    var pending = [];
+
+    var server = http.createServer(function (req, res) {
+        var parsed = url.parse(req.url, true);
+        var slash = parsed.pathname.indexOf("/", 1);
+        var host = slash < 0 ? parsed.pathname.substring(1) : parsed.pathname.substring(1, slash);
+        var pathname = slash < 0 ? "/" : parsed.pathname.substring(slash);
+        var provider = PROVIDERS[host];
+
+        var answer = function (status, body) {
+            var data = typeof body === "string" ? body : JSON.stringify(body);
+            server.requests.push({provider: provider, path: pathname, status: status, bytes: Buffer.byteLength(data)});
+            res.writeHead(status, {"Content-Type": "application/json", "Content-Length": Buffer.byteLength(data)});
+            res.end(data);
+        };
+
+        var dice = random();
+        if (dice < (options.timeoutRate || 0)) {
+            // never answer; the request times out on the phone
+            pending.push(res);
+            return;
+        }
+        setTimeout(function () {
+            if (!provider) {
+                answer(404, {"error": "unknown host " + host});
+                return;
+            }
+            if (dice < (options.timeoutRate || 0) + (options.errorRate || 0)) {
+                answer(500, {"error": "injected error"});
+                return;
+            }
+            if (!recordings[provider]) {
+                recordings[provider] = JSON.parse(fs.readFileSync(path.join(RECORDINGS, provider + ".json"), "utf8"));
+            }
+            var body = RESPONDERS[provider](recordings[provider], pathname, parsed.query);
+            if (body === null) {
+                answer(404, {"error": "no recording for " + pathname});
+            } else {
+                answer(200, body);
+            }
+        }, options.latency || 0);
+    });
+    server.requests = [];
+
+    // requests that never get an answer would keep the server open
+    var close = server.close;
+    server.close = function (callback) {
+        for (var i = 0; i < pending.length; i++) {
+            pending[i].destroy();
+        }
+        pending = [];
+        return close.call(server, callback);
+    };
+    return server;
+}
+
+module.exports = {
+    createServer: createServer,
+    PROVIDERS: PROVIDERS
+};
+
+if (require.main === module) {
+    var args = process.argv.slice(2);
+    var options = {};
+    var port = 8080;
+    for (var i = 0; i < args.length; i++) {
+        if (args[i] == "--port") port = +args[++i];
+        else if (args[i] == "--latency") options.latency = +args[++i];
+        else if (args[i] == "--error-rate") options.errorRate = +args[++i];
+        else if (args[i] == "--timeout-rate") options.timeoutRate = +args[++i];
+        else {
+            console.error("unknown argument: " + args[i]);
+            process.exit(2);
+        }
+    }
+    createServer(options).listen(port, "127.0.0.1", function () {
+        console.log("fake weather server on http://127.0.0.1:" + port + "/<provider host>/<path>");
+    });
+}
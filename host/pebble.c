@@ -0,0 +1,1475 @@
+// Copyright 2015-16 Stefan Heule
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//        http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Software implementation of the Pebble SDK stand-in (see host/include/pebble.h).
+
+#define OBSIDIAN_HOST_NO_ALLOC_WRAP
+#include <math.h>
+#include <stdarg.h>
+#include "host.h"
+
+
+////////////////////////////////////////////
+//// Statistics and profiling
+////////////////////////////////////////////
+
+HostStats host_stats;
+HostStage host_stages[HOST_MAX_STAGES];
+int host_stage_count;
+HostStage host_startup_phases[HOST_MAX_STAGES];
+int host_startup_phase_count;
+
+static int current_stage = -1;
+static uint64_t current_stage_start;
+static uint64_t current_stage_draw_calls;
+
+uint64_t host_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+void host_profile_reset(void) {
+    host_stage_count = 0;
+    current_stage = -1;
+}
+
+static void profile_close_stage(void) {
+    if (current_stage < 0) return;
+    host_stages[current_stage].ns += host_now_ns() - current_stage_start;
+    host_stages[current_stage].draw_calls += host_stats.draw_calls - current_stage_draw_calls;
+    current_stage = -1;
+}
+
+/**
+ * Attributes everything from now until the next stage (or the end of the frame) to the given stage.
+ */
+void profile_stage(const char *stage) {
+    profile_close_stage();
+    int i;
+    for (i = 0; i < host_stage_count; i++) {
+        if (strcmp(host_stages[i].name, stage) == 0) break;
+    }
+    if (i == host_stage_count) {
+        if (host_stage_count == HOST_MAX_STAGES) return;
+        host_stages[i].name = stage;
+        host_stages[i].ns = 0;
+        host_stages[i].draw_calls = 0;
+        host_stage_count += 1;
+    }
+    current_stage = i;
+    current_stage_draw_calls = host_stats.draw_calls;
+    current_stage_start = host_now_ns();
+}
+
+static uint64_t startup_last;
+
+void host_startup_reset(void) {
+    host_startup_phase_count = 0;
+    startup_last = 0;
+}
+
+/**
+ * Records the time since the last startup phase (the first one after host_startup_reset only marks the start).
+ */
+void startup_phase(const char *phase) {
+    const uint64_t now = host_now_ns();
+    if (startup_last != 0 && host_startup_phase_count < HOST_MAX_STAGES) {
+        HostStage *p = &host_startup_phases[host_startup_phase_count++];
+        p->name = phase;
+        p->ns = now - startup_last;
+        p->draw_calls = 0;
+    }
+    startup_last = now;
+}
+
+
+////////////////////////////////////////////
+//// Logging and heap
+////////////////////////////////////////////
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+    static int verbose = -1;
+    if (verbose < 0) {
+        verbose = getenv("OBSIDIAN_HOST_LOG") != NULL;
+    }
+    if (!verbose) return;
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "[%s:%d] ", src_filename, src_line_number);
+    vfprintf(stderr, fmt, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+}
+
+/** Every allocation carries its size in front, so we can report heap_bytes_used. */
+typedef union {
+    size_t size;
+    max_align_t align;
+} HeapHeader;
+
+static size_t heap_used;
+
+void *host_malloc(size_t size) {
+    HeapHeader *header = malloc(sizeof(HeapHeader) + size);
+    if (header == NULL) return NULL;
+    header->size = size;
+    heap_used += size;
+    host_stats.allocations += 1;
+    return header + 1;
+}
+
+void *host_calloc(size_t count, size_t size) {
+    void *ptr = host_malloc(count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void host_free(void *ptr) {
+    if (ptr == NULL) return;
+    HeapHeader *header = ((HeapHeader *) ptr) - 1;
+    heap_used -= header->size;
+    free(header);
+}
+
+void *host_realloc(void *ptr, size_t size) {
+    void *result = host_malloc(size);
+    if (ptr && result) {
+        size_t old = (((HeapHeader *) ptr) - 1)->size;
+        memcpy(result, ptr, old < size ? old : size);
+    }
+    host_free(ptr);
+    return result;
+}
+
+size_t heap_bytes_used(void) {
+    return heap_used;
+}
+
+size_t heap_bytes_free(void) {
+    const size_t heap_size = PBL_IF_COLOR_ELSE(64, 24) * 1024;
+    return heap_used > heap_size ? 0 : heap_size - heap_used;
+}
+
+
+////////////////////////////////////////////
+//// Clock, ticks and timers
+////////////////////////////////////////////
+
+static int64_t now_ms;
+
+struct AppTimer {
+    int64_t fire_at;
+    AppTimerCallback callback;
+    void *data;
+    struct AppTimer *next;
+};
+
+static AppTimer *timers;
+static TickHandler tick_handler;
+static TimeUnits tick_units;
+
+time_t host_time(time_t *tloc) {
+    time_t t = (time_t) (now_ms / 1000);
+    if (tloc) *tloc = t;
+    return t;
+}
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+    uint16_t ms = (uint16_t) (now_ms % 1000);
+    if (tloc) *tloc = (time_t) (now_ms / 1000);
+    if (out_ms) *out_ms = ms;
+    return ms;
+}
+
+void host_set_time(time_t t) {
+    now_ms = (int64_t) t * 1000;
+}
+
+void tick_timer_service_subscribe(TimeUnits units, TickHandler handler) {
+    tick_units = units;
+    tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+    tick_handler = NULL;
+}
+
+void host_tick(TimeUnits units_changed) {
+    if (!tick_handler || !(units_changed & tick_units)) return;
+    time_t t = host_time(NULL);
+    tick_handler(localtime(&t), units_changed);
+}
+
+static void unlink_timer(AppTimer *timer) {
+    for (AppTimer **cur = &timers; *cur; cur = &(*cur)->next) {
+        if (*cur == timer) {
+            *cur = timer->next;
+            return;
+        }
+    }
+}
+
+static bool timer_is_registered(AppTimer *timer) {
+    for (AppTimer *cur = timers; cur; cur = cur->next) {
+        if (cur == timer) return true;
+    }
+    return false;
+}
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+    AppTimer *timer = host_malloc(sizeof(AppTimer));
+    timer->fire_at = now_ms + timeout_ms;
+    timer->callback = callback;
+    timer->data = callback_data;
+    timer->next = timers;
+    timers = timer;
+    return timer;
+}
+
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms) {
+    if (!timer_is_registered(timer)) return false;
+    timer->fire_at = now_ms + new_timeout_ms;
+    return true;
+}
+
+void app_timer_cancel(AppTimer *timer) {
+    if (!timer_is_registered(timer)) return;
+    unlink_timer(timer);
+    host_free(timer);
+}
+
+static void flush_outbox(void);
+
+void host_advance_ms(uint32_t ms) {
+    const int64_t target = now_ms + ms;
+    flush_outbox();
+    while (true) {
+        AppTimer *next = NULL;
+        for (AppTimer *cur = timers; cur; cur = cur->next) {
+            if (cur->fire_at <= target && (next == NULL || cur->fire_at < next->fire_at)) {
+                next = cur;
+            }
+        }
+        if (next == NULL) break;
+        if (next->fire_at > now_ms) now_ms = next->fire_at;
+        unlink_timer(next);
+        AppTimerCallback callback = next->callback;
+        void *data = next->data;
+        host_free(next);
+        callback(data);
+        flush_outbox();
+    }
+    now_ms = target;
+}
+
+void app_event_loop(void) {
+}
+
+
+////////////////////////////////////////////
+//// Trigonometry
+////////////////////////////////////////////
+
+int32_t sin_lookup(int32_t angle) {
+    return (int32_t) lround(sin(2.0 * M_PI * (angle % TRIG_MAX_ANGLE) / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+    return (int32_t) lround(cos(2.0 * M_PI * (angle % TRIG_MAX_ANGLE) / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t atan2_lookup(int16_t y, int16_t x) {
+    int32_t angle = (int32_t) lround(atan2(y, x) / (2.0 * M_PI) * TRIG_MAX_ANGLE);
+    return angle < 0 ? angle + TRIG_MAX_ANGLE : angle;
+}
+
+
+////////////////////////////////////////////
+//// Bitmaps and the framebuffer
+////////////////////////////////////////////
+
+#ifdef PBL_ROUND
+static uint16_t round_row_offset[PBL_DISPLAY_HEIGHT];
+static int16_t round_row_min_x[PBL_DISPLAY_HEIGHT];
+static int16_t round_row_max_x[PBL_DISPLAY_HEIGHT];
+
+/** The round display only stores the pixels inside the circle. */
+static uint32_t round_rows_init(void) {
+    uint32_t offset = 0;
+    const double r = PBL_DISPLAY_WIDTH / 2.0;
+    for (int y = 0; y < PBL_DISPLAY_HEIGHT; y++) {
+        double dy = y + 0.5 - r;
+        int16_t min_x = (int16_t) floor(r - sqrt(r * r - dy * dy));
+        round_row_min_x[y] = min_x;
+        round_row_max_x[y] = (int16_t) (PBL_DISPLAY_WIDTH - 1 - min_x);
+        round_row_offset[y] = (uint16_t) offset;
+        offset += round_row_max_x[y] - min_x + 1;
+    }
+    return offset;
+}
+#endif
+
+static GBitmap *bitmap_create(GSize size, GBitmapFormat format, bool count) {
+    GBitmap *bitmap = count ? host_calloc(1, sizeof(GBitmap)) : calloc(1, sizeof(GBitmap));
+    bitmap->format = format;
+    bitmap->bounds = GRect(0, 0, size.w, size.h);
+    size_t data_size;
+    if (format == GBitmapFormat1Bit) {
+        bitmap->bytes_per_row = (uint16_t) (((size.w + 31) / 32) * 4);
+        data_size = (size_t) bitmap->bytes_per_row * size.h;
+    } else if (format == GBitmapFormat8Bit) {
+        bitmap->bytes_per_row = (uint16_t) size.w;
+        data_size = (size_t) bitmap->bytes_per_row * size.h;
+#ifdef PBL_ROUND
+    } else if (format == GBitmapFormat8BitCircular && size.w == PBL_DISPLAY_WIDTH &&
+               size.h == PBL_DISPLAY_HEIGHT) {
+        bitmap->bytes_per_row = 0;
+        data_size = round_rows_init();
+        bitmap->row_offset = round_row_offset;
+        bitmap->row_min_x = round_row_min_x;
+        bitmap->row_max_x = round_row_max_x;
+#endif
+    } else {
+        if (count) host_free(bitmap); else free(bitmap);
+        return NULL;
+    }
+    bitmap->data = count ? host_calloc(1, data_size) : calloc(1, data_size);
+    bitmap->owns_data = true;
+    return bitmap;
+}
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+    return bitmap_create(size, format, true);
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+    if (bitmap == NULL) return;
+    if (bitmap->owns_data) host_free(bitmap->data);
+    host_free(bitmap);
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+    return bitmap->data;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+    return bitmap->bytes_per_row;
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) {
+    return bitmap->format;
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+    return bitmap->bounds;
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y) {
+    GBitmapDataRowInfo info;
+    if (bitmap->format == GBitmapFormat8BitCircular) {
+        info.min_x = bitmap->row_min_x[y];
+        info.max_x = bitmap->row_max_x[y];
+        info.data = bitmap->data + bitmap->row_offset[y] - info.min_x;
+    } else {
+        info.min_x = 0;
+        info.max_x = (int16_t) (bitmap->bounds.size.w - 1);
+        info.data = bitmap->data + (size_t) y * bitmap->bytes_per_row;
+    }
+    return info;
+}
+
+static GBitmap *framebuffer;
+static GContext graphics_context;
+
+static GContext *host_graphics_context(void) {
+    if (framebuffer == NULL) {
+        const GSize size = GSize(PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+        framebuffer = bitmap_create(size, PBL_IF_ROUND_ELSE(GBitmapFormat8BitCircular,
+                                                            PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit)),
+                                    false);
+        graphics_context.framebuffer = framebuffer;
+    }
+    return &graphics_context;
+}
+
+GBitmap *host_framebuffer(void) {
+    return host_graphics_context()->framebuffer;
+}
+
+static inline bool bitmap_get_pixel(const GBitmap *bitmap, int16_t x, int16_t y, uint8_t *argb) {
+    if (x < 0 || y < 0 || x >= bitmap->bounds.size.w || y >= bitmap->bounds.size.h) return false;
+    if (bitmap->format == GBitmapFormat1Bit) {
+        uint8_t byte = bitmap->data[y * bitmap->bytes_per_row + x / 8];
+        *argb = (byte >> (x % 8)) & 1 ? GColorWhiteARGB8 : GColorBlackARGB8;
+        return true;
+    }
+    GBitmapDataRowInfo info = gbitmap_get_data_row_info(bitmap, (uint16_t) y);
+    if (x < info.min_x || x > info.max_x) return false;
+    *argb = info.data[x];
+    return true;
+}
+
+static inline void bitmap_set_pixel(GBitmap *bitmap, int16_t x, int16_t y, uint8_t argb) {
+    if (bitmap->format == GBitmapFormat1Bit) {
+        GColor8 c = (GColor8) {.argb = argb};
+        uint8_t *byte = &bitmap->data[y * bitmap->bytes_per_row + x / 8];
+        if (c.r + c.g + c.b > 4) {
+            *byte |= (uint8_t) (1 << (x % 8));
+        } else {
+            *byte &= (uint8_t) ~(1 << (x % 8));
+        }
+        return;
+    }
+    GBitmapDataRowInfo info = gbitmap_get_data_row_info(bitmap, (uint16_t) y);
+    if (x < info.min_x || x > info.max_x) return;
+    info.data[x] = argb;
+}
+
+GColor host_framebuffer_pixel(int16_t x, int16_t y) {
+    GColor8 c = GColorBlack;
+    bitmap_get_pixel(host_framebuffer(), x, y, &c.argb);
+    return c;
+}
+
+
+////////////////////////////////////////////
+//// Drawing primitives
+////////////////////////////////////////////
+
+/** Sets a pixel given in layer coordinates, respecting the clip rectangle. */
+static inline void set_pixel(GContext *ctx, int16_t x, int16_t y, GColor color) {
+    x += ctx->offset.x;
+    y += ctx->offset.y;
+    if (x < ctx->clip.origin.x || y < ctx->clip.origin.y ||
+        x >= ctx->clip.origin.x + ctx->clip.size.w || y >= ctx->clip.origin.y + ctx->clip.size.h) {
+        return;
+    }
+    if (color.a == 0) return;
+    bitmap_set_pixel(ctx->framebuffer, x, y, color.argb);
+}
+
+/** Fills the pixels x0..x1 (inclusive) of row y, in layer coordinates. */
+static void fill_span(GContext *ctx, int16_t y, int16_t x0, int16_t x1, GColor color) {
+    if (color.a == 0) return;
+    int32_t sy = y + ctx->offset.y;
+    int32_t sx0 = x0 + ctx->offset.x, sx1 = x1 + ctx->offset.x;
+    if (sy < ctx->clip.origin.y || sy >= ctx->clip.origin.y + ctx->clip.size.h) return;
+    if (sx0 < ctx->clip.origin.x) sx0 = ctx->clip.origin.x;
+    if (sx1 > ctx->clip.origin.x + ctx->clip.size.w - 1) sx1 = ctx->clip.origin.x + ctx->clip.size.w - 1;
+    if (sx0 > sx1) return;
+    GBitmap *bitmap = ctx->framebuffer;
+    if (bitmap->format == GBitmapFormat1Bit) {
+        uint8_t *row = bitmap->data + sy * bitmap->bytes_per_row;
+        const bool white = color.r + color.g + color.b > 4;
+        int32_t x = sx0;
+        for (; x <= sx1 && x % 8 != 0; x++) {
+            bitmap_set_pixel(bitmap, (int16_t) x, (int16_t) sy, color.argb);
+        }
+        for (; x + 7 <= sx1; x += 8) {
+            row[x / 8] = white ? 0xff : 0x00;
+        }
+        for (; x <= sx1; x++) {
+            bitmap_set_pixel(bitmap, (int16_t) x, (int16_t) sy, color.argb);
+        }
+        return;
+    }
+    GBitmapDataRowInfo info = gbitmap_get_data_row_info(bitmap, (uint16_t) sy);
+    if (sx0 < info.min_x) sx0 = info.min_x;
+    if (sx1 > info.max_x) sx1 = info.max_x;
+    if (sx0 > sx1) return;
+    memset(info.data + sx0, color.argb, (size_t) (sx1 - sx0 + 1));
+}
+
+void host_blend_pixel(GContext *ctx, int16_t x, int16_t y, GColor color, uint8_t coverage) {
+    if (coverage >= 16 || ctx->framebuffer->format == GBitmapFormat1Bit) {
+        if (coverage >= 8) set_pixel(ctx, x, y, color);
+        return;
+    }
+    int16_t sx = x + ctx->offset.x;
+    int16_t sy = y + ctx->offset.y;
+    if (sx < ctx->clip.origin.x || sy < ctx->clip.origin.y ||
+        sx >= ctx->clip.origin.x + ctx->clip.size.w || sy >= ctx->clip.origin.y + ctx->clip.size.h) {
+        return;
+    }
+    GColor8 dst;
+    if (!bitmap_get_pixel(ctx->framebuffer, sx, sy, &dst.argb)) return;
+    GColor8 result = {.argb = GColorBlackARGB8};
+    result.r = (uint8_t) ((color.r * coverage + dst.r * (16 - coverage) + 8) / 16);
+    result.g = (uint8_t) ((color.g * coverage + dst.g * (16 - coverage) + 8) / 16);
+    result.b = (uint8_t) ((color.b * coverage + dst.b * (16 - coverage) + 8) / 16);
+    bitmap_set_pixel(ctx->framebuffer, sx, sy, result.argb);
+}
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+    ctx->stroke_color = color;
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+    ctx->fill_color = color;
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+    ctx->text_color = color;
+}
+
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width) {
+    ctx->stroke_width = stroke_width == 0 ? 1 : stroke_width;
+}
+
+void graphics_context_set_antialiased(GContext *ctx, bool enable) {
+    ctx->antialiased = enable;
+}
+
+void graphics_draw_pixel(GContext *ctx, GPoint point) {
+    host_stats.draw_calls += 1;
+    set_pixel(ctx, point.x, point.y, ctx->stroke_color);
+}
+
+static void draw_thin_line(GContext *ctx, GPoint p0, GPoint p1, GColor color) {
+    int dx = abs(p1.x - p0.x), sx = p0.x < p1.x ? 1 : -1;
+    int dy = -abs(p1.y - p0.y), sy = p0.y < p1.y ? 1 : -1;
+    int err = dx + dy;
+    int16_t x = p0.x, y = p0.y;
+    while (true) {
+        set_pixel(ctx, x, y, color);
+        if (x == p1.x && y == p1.y) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+/** Wide lines are drawn as capsules (round caps), like the firmware does. */
+static void draw_wide_line(GContext *ctx, GPoint p0, GPoint p1, uint8_t width, GColor color) {
+    const double r = width / 2.0;
+    const double vx = p1.x - p0.x, vy = p1.y - p0.y;
+    const double len2 = vx * vx + vy * vy;
+    const int16_t min_x = (int16_t) floor(fmin(p0.x, p1.x) - r), max_x = (int16_t) ceil(fmax(p0.x, p1.x) + r);
+    const int16_t min_y = (int16_t) floor(fmin(p0.y, p1.y) - r), max_y = (int16_t) ceil(fmax(p0.y, p1.y) + r);
+    for (int16_t y = min_y; y <= max_y; y++) {
+        for (int16_t x = min_x; x <= max_x; x++) {
+            double t = len2 == 0 ? 0 : ((x - p0.x) * vx + (y - p0.y) * vy) / len2;
+            if (t < 0) t = 0;
+            if (t > 1) t = 1;
+            double ex = p0.x + t * vx - x, ey = p0.y + t * vy - y;
+            if (ex * ex + ey * ey <= r * r) {
+                set_pixel(ctx, x, y, color);
+            }
+        }
+    }
+}
+
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+    host_stats.draw_calls += 1;
+    if (ctx->stroke_width <= 1) {
+        draw_thin_line(ctx, p0, p1, ctx->stroke_color);
+    } else {
+        draw_wide_line(ctx, p0, p1, ctx->stroke_width, ctx->stroke_color);
+    }
+}
+
+void graphics_draw_rect(GContext *ctx, GRect rect) {
+    host_stats.draw_calls += 1;
+    if (rect.size.w <= 0 || rect.size.h <= 0) return;
+    const int16_t x0 = rect.origin.x, y0 = rect.origin.y;
+    const int16_t x1 = x0 + rect.size.w - 1, y1 = y0 + rect.size.h - 1;
+    fill_span(ctx, y0, x0, x1, ctx->stroke_color);
+    fill_span(ctx, y1, x0, x1, ctx->stroke_color);
+    for (int16_t y = y0 + 1; y < y1; y++) {
+        set_pixel(ctx, x0, y, ctx->stroke_color);
+        set_pixel(ctx, x1, y, ctx->stroke_color);
+    }
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+    host_stats.draw_calls += 1;
+    const int16_t r = (int16_t) (corner_mask == GCornerNone ? 0 : corner_radius);
+    for (int16_t i = 0; i < rect.size.h; i++) {
+        int16_t left = 0, right = 0;
+        int16_t from_edge = -1;
+        bool top = i < r, bottom = i >= rect.size.h - r;
+        if (top) from_edge = i;
+        if (bottom) from_edge = (int16_t) (rect.size.h - 1 - i);
+        if (from_edge >= 0) {
+            int16_t d = (int16_t) (r - from_edge);
+            int16_t inset = (int16_t) (r - (int16_t) floor(sqrt((double) r * r - (d - 0.5) * (d - 0.5))));
+            if ((top && (corner_mask & GCornerTopLeft)) || (bottom && (corner_mask & GCornerBottomLeft))) left = inset;
+            if ((top && (corner_mask & GCornerTopRight)) || (bottom && (corner_mask & GCornerBottomRight))) right = inset;
+        }
+        fill_span(ctx, (int16_t) (rect.origin.y + i), (int16_t) (rect.origin.x + left),
+                  (int16_t) (rect.origin.x + rect.size.w - 1 - right), ctx->fill_color);
+    }
+}
+
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius) {
+    host_stats.draw_calls += 1;
+    int x = radius, y = 0, err = 1 - x;
+    while (x >= y) {
+        set_pixel(ctx, p.x + x, p.y + y, ctx->stroke_color);
+        set_pixel(ctx, p.x + y, p.y + x, ctx->stroke_color);
+        set_pixel(ctx, p.x - y, p.y + x, ctx->stroke_color);
+        set_pixel(ctx, p.x - x, p.y + y, ctx->stroke_color);
+        set_pixel(ctx, p.x - x, p.y - y, ctx->stroke_color);
+        set_pixel(ctx, p.x - y, p.y - x, ctx->stroke_color);
+        set_pixel(ctx, p.x + y, p.y - x, ctx->stroke_color);
+        set_pixel(ctx, p.x + x, p.y - y, ctx->stroke_color);
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius) {
+    host_stats.draw_calls += 1;
+    const int32_t r = radius;
+    for (int32_t dy = -r; dy <= r; dy++) {
+        int16_t half = (int16_t) floor(sqrt((double) (r * r + r - dy * dy)));
+        fill_span(ctx, (int16_t) (p.y + dy), (int16_t) (p.x - half), (int16_t) (p.x + half), ctx->fill_color);
+    }
+}
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+    host_stats.draw_calls += 1;
+    const GRect src = bitmap->bounds;
+    for (int16_t y = 0; y < rect.size.h; y++) {
+        for (int16_t x = 0; x < rect.size.w; x++) {
+            uint8_t argb;
+            if (bitmap_get_pixel(bitmap, (int16_t) (src.origin.x + x % src.size.w),
+                                 (int16_t) (src.origin.y + y % src.size.h), &argb)) {
+                set_pixel(ctx, (int16_t) (rect.origin.x + x), (int16_t) (rect.origin.y + y), (GColor8) {.argb = argb});
+            }
+        }
+    }
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+    if (ctx->captured) return NULL;
+    ctx->captured = true;
+    return ctx->framebuffer;
+}
+
+GBitmap *graphics_capture_frame_buffer_format(GContext *ctx, GBitmapFormat format) {
+    if (ctx->framebuffer->format != format) return NULL;
+    return graphics_capture_frame_buffer(ctx);
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+    if (!ctx->captured || buffer != ctx->framebuffer) return false;
+    ctx->captured = false;
+    return true;
+}
+
+
+////////////////////////////////////////////
+//// Paths
+////////////////////////////////////////////
+
+GPath *gpath_create(const GPathInfo *init) {
+    GPath *path = host_malloc(sizeof(GPath) + init->num_points * sizeof(GPoint));
+    path->num_points = init->num_points;
+    path->points = (GPoint *) (path + 1);
+    memcpy(path->points, init->points, init->num_points * sizeof(GPoint));
+    path->rotation = 0;
+    path->offset = GPointZero;
+    return path;
+}
+
+void gpath_destroy(GPath *path) {
+    host_free(path);
+}
+
+void gpath_rotate_to(GPath *path, int32_t angle) {
+    path->rotation = angle;
+}
+
+void gpath_move_to(GPath *path, GPoint point) {
+    path->offset = point;
+}
+
+static GPoint gpath_point(const GPath *path, uint32_t i) {
+    const int32_t s = sin_lookup(path->rotation), c = cos_lookup(path->rotation);
+    const GPoint p = path->points[i];
+    return GPoint((int16_t) ((p.x * c - p.y * s) / TRIG_MAX_RATIO + path->offset.x),
+                  (int16_t) ((p.x * s + p.y * c) / TRIG_MAX_RATIO + path->offset.y));
+}
+
+void gpath_draw_filled(GContext *ctx, GPath *path) {
+    host_stats.draw_calls += 1;
+    if (path->num_points < 3) return;
+    GPoint points[path->num_points];
+    int16_t min_y = INT16_MAX, max_y = INT16_MIN;
+    for (uint32_t i = 0; i < path->num_points; i++) {
+        points[i] = gpath_point(path, i);
+        if (points[i].y < min_y) min_y = points[i].y;
+        if (points[i].y > max_y) max_y = points[i].y;
+    }
+    int32_t crossings[path->num_points];
+    for (int16_t y = min_y; y <= max_y; y++) {
+        const double cy = y + 0.5;
+        uint32_t n = 0;
+        for (uint32_t i = 0; i < path->num_points; i++) {
+            GPoint a = points[i], b = points[(i + 1) % path->num_points];
+            if ((a.y <= cy && b.y > cy) || (b.y <= cy && a.y > cy)) {
+                crossings[n++] = (int32_t) lround(a.x + (cy - a.y) * (b.x - a.x) / (b.y - a.y));
+            }
+        }
+        for (uint32_t i = 1; i < n; i++) {
+            for (uint32_t j = i; j > 0 && crossings[j - 1] > crossings[j]; j--) {
+                int32_t tmp = crossings[j];
+                crossings[j] = crossings[j - 1];
+                crossings[j - 1] = tmp;
+            }
+        }
+        for (uint32_t i = 0; i + 1 < n; i += 2) {
+            fill_span(ctx, y, (int16_t) crossings[i], (int16_t) crossings[i + 1], ctx->fill_color);
+        }
+    }
+}
+
+void gpath_draw_outline(GContext *ctx, GPath *path) {
+    host_stats.draw_calls += 1;
+    for (uint32_t i = 0; i < path->num_points; i++) {
+        draw_thin_line(ctx, gpath_point(path, i), gpath_point(path, (i + 1) % path->num_points), ctx->stroke_color);
+    }
+}
+
+
+////////////////////////////////////////////
+//// Resources and fonts
+////////////////////////////////////////////
+
+#ifndef OBSIDIAN_HOST_RESOURCES
+#define OBSIDIAN_HOST_RESOURCES "resources"
+#endif
+
+typedef struct {
+    uint32_t id;
+    const char *file;
+    uint8_t *data;
+    size_t size;
+} HostResource;
+
+// the system fonts and the bitmap font for aplite/diorite are replaced with the vector fonts
+static HostResource resources[] = {
+        {RESOURCE_ID_MAIN_FFONT,        "OpenSans-CondensedBold.ffont",        NULL, 0},
+        {RESOURCE_ID_MAIN_DIGITS_FFONT, "OpenSans-CondensedBold-digits.ffont", NULL, 0},
+        {RESOURCE_ID_WEATHER_FFONT,     "nupe2.ffont",                         NULL, 0},
+        {RESOURCE_ID_NUPE_23,           "nupe2.ffont",                         NULL, 0},
+};
+
+const uint8_t *host_resource_data(uint32_t resource_id, size_t *size) {
+    for (unsigned i = 0; i < ARRAY_LENGTH(resources); i++) {
+        HostResource *res = &resources[i];
+        if (res->id != resource_id) continue;
+        if (res->data == NULL) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/%s", OBSIDIAN_HOST_RESOURCES, res->file);
+            FILE *f = fopen(path, "rb");
+            if (f == NULL) {
+                fprintf(stderr, "cannot open resource %s\n", path);
+                exit(1);
+            }
+            fseek(f, 0, SEEK_END);
+            res->size = (size_t) ftell(f);
+            fseek(f, 0, SEEK_SET);
+            res->data = malloc(res->size);
+            if (fread(res->data, 1, res->size, f) != res->size) {
+                fprintf(stderr, "cannot read resource %s\n", path);
+                exit(1);
+            }
+            fclose(f);
+        }
+        *size = res->size;
+        return res->data;
+    }
+    return NULL;
+}
+
+ResHandle resource_get_handle(uint32_t resource_id) {
+    for (unsigned i = 0; i < ARRAY_LENGTH(resources); i++) {
+        if (resources[i].id == resource_id) return &resources[i];
+    }
+    return NULL;
+}
+
+size_t resource_size(ResHandle h) {
+    size_t size = 0;
+    host_resource_data(((const HostResource *) h)->id, &size);
+    return size;
+}
+
+size_t resource_load(ResHandle h, uint8_t *buffer, size_t max_length) {
+    size_t size = 0;
+    const uint8_t *data = host_resource_data(((const HostResource *) h)->id, &size);
+    if (size > max_length) size = max_length;
+    memcpy(buffer, data, size);
+    return size;
+}
+
+GFont fonts_get_system_font(const char *font_key) {
+    static struct HostFont system_fonts[8];
+    static const char *keys[8];
+    for (unsigned i = 0; i < ARRAY_LENGTH(system_fonts); i++) {
+        if (keys[i] && strcmp(keys[i], font_key) == 0) return &system_fonts[i];
+        if (keys[i] == NULL) {
+            size_t size;
+            const char *digits = strpbrk(font_key, "0123456789");
+            keys[i] = font_key;
+            system_fonts[i].ffont = (FFont *) host_resource_data(RESOURCE_ID_MAIN_FFONT, &size);
+            system_fonts[i].size = (int16_t) (digits ? atoi(digits) : 18);
+            system_fonts[i].system = true;
+            return &system_fonts[i];
+        }
+    }
+    return NULL;
+}
+
+GFont fonts_load_custom_font(ResHandle handle) {
+    const HostResource *res = handle;
+    size_t size;
+    struct HostFont *font = host_malloc(sizeof(struct HostFont));
+    font->ffont = (FFont *) host_resource_data(res->id, &size);
+    font->size = 23;
+    font->system = false;
+    return font;
+}
+
+void fonts_unload_custom_font(GFont font) {
+    if (font && !font->system) host_free(font);
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, GFont const font, const GRect box,
+                        const GTextOverflowMode overflow_mode, const GTextAlignment alignment,
+                        GTextAttributes *text_attributes) {
+    host_stats.draw_calls += 1;
+    int16_t w = (int16_t) FIXED_TO_INT(host_text_width(font->ffont, font->size, text));
+    int16_t x = box.origin.x;
+    if (alignment == GTextAlignmentCenter) x += (box.size.w - w) / 2;
+    if (alignment == GTextAlignmentRight) x += box.size.w - w;
+    host_draw_text(ctx, font->ffont, font->size, x, (int16_t) (box.origin.y + font->size / 4), text, ctx->text_color);
+}
+
+GSize graphics_text_layout_get_content_size(const char *text, GFont const font, const GRect box,
+                                            const GTextOverflowMode overflow_mode, const GTextAlignment alignment) {
+    fixed_t w = host_text_width(font->ffont, font->size, text);
+    return GSize((int16_t) FIXED_TO_INT(w + FIXED_POINT_SCALE - 1), font->size);
+}
+
+
+////////////////////////////////////////////
+//// Layers and windows
+////////////////////////////////////////////
+
+struct Layer {
+    GRect frame;
+    GRect bounds;
+    LayerUpdateProc update_proc;
+    Layer *parent;
+    Layer *first_child;
+    Layer *next_sibling;
+    bool hidden;
+    bool dirty;
+};
+
+struct Window {
+    Layer *root;
+    WindowHandlers handlers;
+    GColor background;
+    bool loaded;
+};
+
+static Window *top_window;
+static int16_t unobstructed_height = PBL_DISPLAY_HEIGHT;
+
+GPoint grect_center_point(const GRect *rect) {
+    return GPoint((int16_t) (rect->origin.x + rect->size.w / 2), (int16_t) (rect->origin.y + rect->size.h / 2));
+}
+
+bool grect_equal(const GRect *const rect_a, const GRect *const rect_b) {
+    return memcmp(rect_a, rect_b, sizeof(GRect)) == 0;
+}
+
+bool gpoint_equal(const GPoint *const point_a, const GPoint *const point_b) {
+    return point_a->x == point_b->x && point_a->y == point_b->y;
+}
+
+Layer *layer_create(GRect frame) {
+    Layer *layer = host_calloc(1, sizeof(Layer));
+    layer->frame = frame;
+    layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+    layer->dirty = true;
+    return layer;
+}
+
+void layer_remove_from_parent(Layer *child) {
+    if (child->parent == NULL) return;
+    for (Layer **cur = &child->parent->first_child; *cur; cur = &(*cur)->next_sibling) {
+        if (*cur == child) {
+            *cur = child->next_sibling;
+            break;
+        }
+    }
+    child->parent = NULL;
+    child->next_sibling = NULL;
+}
+
+void layer_destroy(Layer *layer) {
+    if (layer == NULL) return;
+    layer_remove_from_parent(layer);
+    host_free(layer);
+}
+
+void layer_mark_dirty(Layer *layer) {
+    layer->dirty = true;
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+    layer->update_proc = update_proc;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+    layer->frame = frame;
+    layer->bounds.size = frame.size;
+    layer->dirty = true;
+}
+
+GRect layer_get_frame(const Layer *layer) {
+    return layer->frame;
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+    return layer->bounds;
+}
+
+GRect layer_get_unobstructed_bounds(const Layer *layer) {
+    GRect bounds = layer->bounds;
+    int16_t top = layer->frame.origin.y;
+    for (const Layer *p = layer->parent; p; p = p->parent) {
+        top += p->frame.origin.y;
+    }
+    int16_t visible = (int16_t) (unobstructed_height - top);
+    if (visible < bounds.size.h) bounds.size.h = visible < 0 ? 0 : visible;
+    return bounds;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+    layer_remove_from_parent(child);
+    child->parent = parent;
+    Layer **cur = &parent->first_child;
+    while (*cur) cur = &(*cur)->next_sibling;
+    *cur = child;
+    child->dirty = true;
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+    layer->hidden = hidden;
+    layer->dirty = true;
+}
+
+bool layer_get_hidden(const Layer *layer) {
+    return layer->hidden;
+}
+
+Window *window_create(void) {
+    Window *window = host_calloc(1, sizeof(Window));
+    window->root = layer_create(GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT));
+    window->background = GColorWhite;
+    return window;
+}
+
+void window_destroy(Window *window) {
+    if (window == NULL) return;
+    if (window->loaded && window->handlers.unload) {
+        window->handlers.unload(window);
+    }
+    if (top_window == window) top_window = NULL;
+    layer_destroy(window->root);
+    host_free(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+    window->handlers = handlers;
+}
+
+void window_set_background_color(Window *window, GColor background_color) {
+    window->background = background_color;
+}
+
+Layer *window_get_root_layer(const Window *window) {
+    return window->root;
+}
+
+void window_stack_push(Window *window, bool animated) {
+    top_window = window;
+    if (!window->loaded) {
+        window->loaded = true;
+        if (window->handlers.load) window->handlers.load(window);
+    }
+    if (window->handlers.appear) window->handlers.appear(window);
+}
+
+void host_set_unobstructed_height(int16_t height) {
+    unobstructed_height = height;
+    if (top_window) layer_mark_dirty(top_window->root);
+}
+
+static bool tree_is_dirty(const Layer *layer) {
+    if (layer->dirty) return true;
+    for (const Layer *child = layer->first_child; child; child = child->next_sibling) {
+        if (tree_is_dirty(child)) return true;
+    }
+    return false;
+}
+
+static void render_layer(GContext *ctx, Layer *layer, GPoint origin, GRect clip) {
+    layer->dirty = false;
+    if (layer->hidden) return;
+    origin.x += layer->frame.origin.x;
+    origin.y += layer->frame.origin.y;
+    int16_t x0 = origin.x > clip.origin.x ? origin.x : clip.origin.x;
+    int16_t y0 = origin.y > clip.origin.y ? origin.y : clip.origin.y;
+    int16_t x1 = origin.x + layer->frame.size.w, cx1 = clip.origin.x + clip.size.w;
+    int16_t y1 = origin.y + layer->frame.size.h, cy1 = clip.origin.y + clip.size.h;
+    if (cx1 < x1) x1 = cx1;
+    if (cy1 < y1) y1 = cy1;
+    clip = GRect(x0, y0, x1 > x0 ? x1 - x0 : 0, y1 > y0 ? y1 - y0 : 0);
+    if (layer->update_proc) {
+        ctx->offset = origin;
+        ctx->clip = clip;
+        ctx->stroke_color = GColorBlack;
+        ctx->fill_color = GColorBlack;
+        ctx->text_color = GColorBlack;
+        ctx->stroke_width = 1;
+        ctx->antialiased = true;
+        layer->update_proc(layer, ctx);
+    }
+    for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+        render_layer(ctx, child, origin, clip);
+    }
+}
+
+bool host_render(void) {
+    if (top_window == NULL || !tree_is_dirty(top_window->root)) return false;
+    GContext *ctx = host_graphics_context();
+    profile_stage("system");
+    if (top_window->background.a != 0) {
+        const GRect screen = GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT);
+        ctx->offset = GPointZero;
+        ctx->clip = screen;
+        for (int16_t y = 0; y < PBL_DISPLAY_HEIGHT; y++) {
+            fill_span(ctx, y, 0, PBL_DISPLAY_WIDTH - 1, top_window->background);
+        }
+    }
+    render_layer(ctx, top_window->root, GPointZero, GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT));
+    profile_close_stage();
+    host_stats.frames += 1;
+    return true;
+}
+
+
+////////////////////////////////////////////
+//// Services
+////////////////////////////////////////////
+
+static BatteryChargeState battery_state = {.charge_percent = 80, .is_charging = false, .is_plugged = false};
+static BatteryStateHandler battery_handler;
+static bool bluetooth_connected = true;
+static BluetoothConnectionHandler bluetooth_handler;
+static bool quiet_time;
+
+BatteryChargeState battery_state_service_peek(void) {
+    return battery_state;
+}
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+    battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void) {
+    battery_handler = NULL;
+}
+
+void host_set_battery(uint8_t charge_percent, bool is_charging, bool is_plugged) {
+    battery_state.charge_percent = charge_percent;
+    battery_state.is_charging = is_charging;
+    battery_state.is_plugged = is_plugged;
+    if (battery_handler) battery_handler(battery_state);
+}
+
+bool bluetooth_connection_service_peek(void) {
+    return bluetooth_connected;
+}
+
+void bluetooth_connection_service_subscribe(BluetoothConnectionHandler handler) {
+    bluetooth_handler = handler;
+}
+
+void bluetooth_connection_service_unsubscribe(void) {
+    bluetooth_handler = NULL;
+}
+
+void host_set_bluetooth(bool connected) {
+    bluetooth_connected = connected;
+    if (bluetooth_handler) bluetooth_handler(connected);
+}
+
+bool quiet_time_is_active(void) {
+    return quiet_time;
+}
+
+void host_set_quiet_time(bool active) {
+    quiet_time = active;
+}
+
+void vibes_double_pulse(void) {
+}
+
+void vibes_short_pulse(void) {
+}
+
+void light_enable_interaction(void) {
+}
+
+
+////////////////////////////////////////////
+//// Persistent storage
+////////////////////////////////////////////
+
+typedef struct {
+    uint32_t key;
+    uint16_t size;
+    uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} PersistEntry;
+
+static PersistEntry persist[256];
+static unsigned persist_count;
+
+static PersistEntry *persist_find(const uint32_t key) {
+    for (unsigned i = 0; i < persist_count; i++) {
+        if (persist[i].key == key) return &persist[i];
+    }
+    return NULL;
+}
+
+void host_persist_reset(void) {
+    persist_count = 0;
+}
+
+bool persist_exists(const uint32_t key) {
+    host_stats.persist_reads += 1;
+    return persist_find(key) != NULL;
+}
+
+int persist_get_size(const uint32_t key) {
+    host_stats.persist_reads += 1;
+    PersistEntry *entry = persist_find(key);
+    return entry ? entry->size : E_DOES_NOT_EXIST;
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+    host_stats.persist_reads += 1;
+    PersistEntry *entry = persist_find(key);
+    if (entry == NULL) return E_DOES_NOT_EXIST;
+    size_t size = entry->size < buffer_size ? entry->size : buffer_size;
+    memcpy(buffer, entry->data, size);
+    return (int) size;
+}
+
+int32_t persist_read_int(const uint32_t key) {
+    int32_t value = 0;
+    persist_read_data(key, &value, sizeof(value));
+    return value;
+}
+
+bool persist_read_bool(const uint32_t key) {
+    return persist_read_int(key) != 0;
+}
+
+int persist_read_string(const uint32_t key, char *buffer, const size_t buffer_size) {
+    int size = persist_read_data(key, buffer, buffer_size);
+    if (size > 0) buffer[size - 1] = 0;
+    return size;
+}
+
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+    host_stats.persist_writes += 1;
+    if (size > PERSIST_DATA_MAX_LENGTH) return E_RANGE;
+    PersistEntry *entry = persist_find(key);
+    if (entry == NULL) {
+        if (persist_count == ARRAY_LENGTH(persist)) return E_OUT_OF_STORAGE;
+        entry = &persist[persist_count++];
+        entry->key = key;
+    }
+    entry->size = (uint16_t) size;
+    memcpy(entry->data, data, size);
+    return (int) size;
+}
+
+status_t persist_write_int(const uint32_t key, const int32_t value) {
+    return persist_write_data(key, &value, sizeof(value));
+}
+
+status_t persist_write_bool(const uint32_t key, const bool value) {
+    return persist_write_int(key, value);
+}
+
+int persist_write_string(const uint32_t key, const char *cstring) {
+    return persist_write_data(key, cstring, strlen(cstring) + 1);
+}
+
+status_t persist_delete(const uint32_t key) {
+    host_stats.persist_writes += 1;
+    PersistEntry *entry = persist_find(key);
+    if (entry == NULL) return E_DOES_NOT_EXIST;
+    *entry = persist[--persist_count];
+    return S_SUCCESS;
+}
+
+
+////////////////////////////////////////////
+//// Dictionaries
+////////////////////////////////////////////
+
+struct __attribute__((__packed__)) Dictionary {
+    uint8_t count;
+    Tuple head[];
+};
+
+#define TUPLE_HEADER_SIZE ((uint32_t) sizeof(Tuple))
+
+static Tuple *next_tuple(const Tuple *tuple) {
+    return (Tuple *) ((const uint8_t *) tuple + TUPLE_HEADER_SIZE + tuple->length);
+}
+
+uint32_t dict_calc_buffer_size(const uint8_t tuple_count, ...) {
+    va_list args;
+    va_start(args, tuple_count);
+    uint32_t size = sizeof(Dictionary);
+    for (uint8_t i = 0; i < tuple_count; i++) {
+        size += TUPLE_HEADER_SIZE + va_arg(args, uint32_t);
+    }
+    va_end(args);
+    return size;
+}
+
+DictionaryResult dict_write_begin(DictionaryIterator *iter, uint8_t *const buffer, const uint16_t size) {
+    if (iter == NULL || buffer == NULL || size < sizeof(Dictionary)) return DICT_INVALID_ARGS;
+    iter->dictionary = (Dictionary *) buffer;
+    iter->dictionary->count = 0;
+    iter->cursor = iter->dictionary->head;
+    iter->end = buffer + size;
+    return DICT_OK;
+}
+
+static DictionaryResult dict_write_tuple(DictionaryIterator *iter, const uint32_t key, TupleType type,
+                                         const void *data, const uint16_t size) {
+    if ((const uint8_t *) iter->cursor + TUPLE_HEADER_SIZE + size > (const uint8_t *) iter->end) {
+        return DICT_NOT_ENOUGH_STORAGE;
+    }
+    iter->cursor->key = key;
+    iter->cursor->type = type;
+    iter->cursor->length = size;
+    memcpy(iter->cursor->value->data, data, size);
+    iter->cursor = next_tuple(iter->cursor);
+    iter->dictionary->count += 1;
+    return DICT_OK;
+}
+
+DictionaryResult dict_write_data(DictionaryIterator *iter, const uint32_t key, const uint8_t *const data,
+                                 const uint16_t size) {
+    return dict_write_tuple(iter, key, TUPLE_BYTE_ARRAY, data, size);
+}
+
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, const uint32_t key, const char *const cstring) {
+    return dict_write_tuple(iter, key, TUPLE_CSTRING, cstring, (uint16_t) (strlen(cstring) + 1));
+}
+
+DictionaryResult dict_write_int(DictionaryIterator *iter, const uint32_t key, const void *integer,
+                                const uint8_t width_bytes, const bool is_signed) {
+    return dict_write_tuple(iter, key, is_signed ? TUPLE_INT : TUPLE_UINT, integer, width_bytes);
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, const uint32_t key, const uint8_t value) {
+    return dict_write_int(iter, key, &value, 1, false);
+}
+
+DictionaryResult dict_write_uint16(DictionaryIterator *iter, const uint32_t key, const uint16_t value) {
+    return dict_write_int(iter, key, &value, 2, false);
+}
+
+DictionaryResult dict_write_uint32(DictionaryIterator *iter, const uint32_t key, const uint32_t value) {
+    return dict_write_int(iter, key, &value, 4, false);
+}
+
+DictionaryResult dict_write_int8(DictionaryIterator *iter, const uint32_t key, const int8_t value) {
+    return dict_write_int(iter, key, &value, 1, true);
+}
+
+DictionaryResult dict_write_int16(DictionaryIterator *iter, const uint32_t key, const int16_t value) {
+    return dict_write_int(iter, key, &value, 2, true);
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value) {
+    return dict_write_int(iter, key, &value, 4, true);
+}
+
+uint32_t dict_write_end(DictionaryIterator *iter) {
+    iter->end = iter->cursor;
+    return (uint32_t) ((const uint8_t *) iter->cursor - (const uint8_t *) iter->dictionary);
+}
+
+Tuple *dict_read_begin_from_buffer(DictionaryIterator *iter, const uint8_t *const buffer, const uint16_t size) {
+    iter->dictionary = (Dictionary *) buffer;
+    iter->end = buffer + size;
+    return dict_read_first(iter);
+}
+
+Tuple *dict_read_first(DictionaryIterator *iter) {
+    iter->cursor = iter->dictionary->head;
+    if (iter->dictionary->count == 0 || (const void *) iter->cursor >= iter->end) return NULL;
+    return iter->cursor;
+}
+
+Tuple *dict_read_next(DictionaryIterator *iter) {
+    iter->cursor = next_tuple(iter->cursor);
+    if ((const void *) iter->cursor >= iter->end) return NULL;
+    return iter->cursor;
+}
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key) {
+    Tuple *tuple = iter->dictionary->head;
+    for (uint8_t i = 0; i < iter->dictionary->count && (const void *) tuple < iter->end; i++) {
+        if (tuple->key == key) return tuple;
+        tuple = next_tuple(tuple);
+    }
+    return NULL;
+}
+
+
+////////////////////////////////////////////
+//// App messages
+////////////////////////////////////////////
+
+static AppMessageInboxReceived inbox_received;
+static AppMessageInboxDropped inbox_dropped;
+static AppMessageOutboxSent outbox_sent;
+static AppMessageOutboxFailed outbox_failed;
+static uint8_t *outbox_buffer;
+static DictionaryIterator outbox_iter;
+static bool outbox_pending;
+static uint8_t phone_buffer[4096];
+static DictionaryIterator phone_iter;
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+    if (outbox_buffer) return APP_MSG_INVALID_STATE;
+    // the buffers live on the app heap
+    host_free(host_malloc(size_inbound));
+    outbox_buffer = host_malloc(size_outbound);
+    host_stats.inbox_size = size_inbound;
+    host_stats.outbox_size = size_outbound;
+    return APP_MSG_OK;
+}
+
+void app_message_deregister_callbacks(void) {
+    inbox_received = NULL;
+    inbox_dropped = NULL;
+    outbox_sent = NULL;
+    outbox_failed = NULL;
+}
+
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived received_callback) {
+    AppMessageInboxReceived old = inbox_received;
+    inbox_received = received_callback;
+    return old;
+}
+
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback) {
+    AppMessageInboxDropped old = inbox_dropped;
+    inbox_dropped = dropped_callback;
+    return old;
+}
+
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent sent_callback) {
+    AppMessageOutboxSent old = outbox_sent;
+    outbox_sent = sent_callback;
+    return old;
+}
+
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback) {
+    AppMessageOutboxFailed old = outbox_failed;
+    outbox_failed = failed_callback;
+    return old;
+}
+
+uint32_t app_message_inbox_size_maximum(void) {
+    return 8200;
+}
+
+uint32_t app_message_outbox_size_maximum(void) {
+    return 8200;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator) {
+    if (outbox_buffer == NULL) return APP_MSG_INVALID_STATE;
+    if (outbox_pending) return APP_MSG_BUSY;
+    dict_write_begin(&outbox_iter, outbox_buffer, (uint16_t) host_stats.outbox_size);
+    *iterator = &outbox_iter;
+    return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_send(void) {
+    if (outbox_buffer == NULL) return APP_MSG_INVALID_STATE;
+    if (outbox_pending) return APP_MSG_BUSY;
+    host_stats.messages_sent += 1;
+    host_stats.bytes_sent += dict_write_end(&outbox_iter);
+    outbox_pending = true;
+    return APP_MSG_OK;
+}
+
+/** The phone acknowledges outgoing messages the next time the simulation advances. */
+static void flush_outbox(void) {
+    if (!outbox_pending) return;
+    outbox_pending = false;
+    if (outbox_sent) outbox_sent(&outbox_iter, NULL);
+}
+
+DictionaryIterator *host_message_begin(void) {
+    dict_write_begin(&phone_iter, phone_buffer, sizeof(phone_buffer));
+    return &phone_iter;
+}
+
+bool host_message_deliver(void) {
+    uint32_t size = dict_write_end(&phone_iter);
+    if (size > host_stats.inbox_size) {
+        if (inbox_dropped) inbox_dropped(APP_MSG_BUFFER_OVERFLOW, NULL);
+        return false;
+    }
+    host_stats.messages_received += 1;
+    host_stats.bytes_received += size;
+    DictionaryIterator iter;
+    dict_read_begin_from_buffer(&iter, phone_buffer, (uint16_t) size);
+    if (inbox_received) inbox_received(&iter, NULL);
+    return true;
+}
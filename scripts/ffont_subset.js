@@ -0,0 +1,98 @@
+// Writes a subset of an .ffont font (as produced by pebble-fctx-compiler) with only the glyphs whose characters
+// match a regular expression, e.g. a character class like the -r option of the compiler.  The outlines are copied
+// unchanged, so text drawn with the subset looks exactly like text drawn with the full font.
+//
+// usage: node scripts/ffont_subset.js -r REGEX <input.ffont> <output.ffont>
+
+var fs = require('fs');
+
+var HEADER_SIZE = 12;
+var RANGE_SIZE = 4;
+var GLYPH_SIZE = 6;
+
+/**
+ * Parses a font: the header fields, and every glyph with its character, advance and outline.
+ */
+function readFont(data) {
+    var font = {
+        unitsPerEm: data.readInt16LE(0),
+        ascent: data.readInt16LE(2),
+        descent: data.readInt16LE(4),
+        capHeight: data.readInt16LE(6),
+        glyphs: []
+    };
+    var rangeCount = data.readUInt16LE(8);
+    var glyphCount = data.readUInt16LE(10);
+    var glyphs = HEADER_SIZE + rangeCount * RANGE_SIZE;
+    var paths = glyphs + glyphCount * GLYPH_SIZE;
+    var index = 0;
+    for (var r = 0; r < rangeCount; r++) {
+        var begin = data.readUInt16LE(HEADER_SIZE + r * RANGE_SIZE);
+        var end = data.readUInt16LE(HEADER_SIZE + r * RANGE_SIZE + 2);
+        for (var c = begin; c < end; c++, index++) {
+            var offset = data.readUInt16LE(glyphs + index * GLYPH_SIZE);
+            var length = data.readUInt16LE(glyphs + index * GLYPH_SIZE + 2);
+            font.glyphs.push({
+                code: c,
+                advance: data.readInt16LE(glyphs + index * GLYPH_SIZE + 4),
+                path: data.slice(paths + offset, paths + offset + length)
+            });
+        }
+    }
+    return font;
+}
+
+/**
+ * Serializes a font, with one range for every run of consecutive characters (glyphs must be sorted).
+ */
+function writeFont(font) {
+    var ranges = [];
+    font.glyphs.forEach(function (glyph) {
+        var last = ranges[ranges.length - 1];
+        if (last && last.end == glyph.code) {
+            last.end += 1;
+        } else {
+            ranges.push({begin: glyph.code, end: glyph.code + 1});
+        }
+    });
+    var pathSize = font.glyphs.reduce(function (size, glyph) {
+        return size + glyph.path.length;
+    }, 0);
+    var glyphs = HEADER_SIZE + ranges.length * RANGE_SIZE;
+    var paths = glyphs + font.glyphs.length * GLYPH_SIZE;
+    var data = Buffer.alloc(paths + pathSize);
+    data.writeInt16LE(font.unitsPerEm, 0);
+    data.writeInt16LE(font.ascent, 2);
+    data.writeInt16LE(font.descent, 4);
+    data.writeInt16LE(font.capHeight, 6);
+    data.writeUInt16LE(ranges.length, 8);
+    data.writeUInt16LE(font.glyphs.length, 10);
+    ranges.forEach(function (range, i) {
+        data.writeUInt16LE(range.begin, HEADER_SIZE + i * RANGE_SIZE);
+        data.writeUInt16LE(range.end, HEADER_SIZE + i * RANGE_SIZE + 2);
+    });
+    var offset = 0;
+    font.glyphs.forEach(function (glyph, i) {
+        data.writeUInt16LE(offset, glyphs + i * GLYPH_SIZE);
+        data.writeUInt16LE(glyph.path.length, glyphs + i * GLYPH_SIZE + 2);
+        data.writeInt16LE(glyph.advance, glyphs + i * GLYPH_SIZE + 4);
+        glyph.path.copy(data, paths + offset);
+        offset += glyph.path.length;
+    });
+    return data;
+}
+
+var args = process.argv.slice(2);
+if (args.length != 4 || args[0] != "-r") {
+    console.error("usage: node scripts/ffont_subset.js -r REGEX <input.ffont> <output.ffont>");
+    process.exit(2);
+}
+var regex = new RegExp(args[1]);
+var font = readFont(fs.readFileSync(args[2]));
+var all = font.glyphs.length;
+font.glyphs = font.glyphs.filter(function (glyph) {
+    return regex.test(String.fromCharCode(glyph.code));
+});
+var data = writeFont(font);
+fs.writeFileSync(args[3], data);
+console.log(args[3] + ": " + font.glyphs.length + " of " + all + " glyphs, " + data.length + " bytes");
@@ -16,6 +16,89 @@
 #include "obsidian.h"
 
 
+#ifdef PBL_COLOR
+/** The characters (Unicode code points) covered by the advance tables. */
+#define ADVANCE_TABLE_CHARS 256
+
+/**
+ * Horizontal advance of every character of a font, in font units (the width scales with the em size).
+ */
+typedef struct {
+    FFont *font;
+    int16_t advance[ADVANCE_TABLE_CHARS];
+} AdvanceTable;
+
+/** One table for each font the date and weather are measured in. */
+static AdvanceTable advance_tables[2];
+static uint8_t advance_table_count = 0;
+
+/**
+ * The advance table of the given font, or NULL if there is none.
+ */
+static const AdvanceTable *advance_table_find(FFont *font) {
+    for (uint8_t i = 0; i < advance_table_count; i++) {
+        if (advance_tables[i].font == font) return &advance_tables[i];
+    }
+    return NULL;
+}
+
+static void advance_table_add(FFont *font) {
+    if (font == NULL || advance_table_find(font)) return;
+    AdvanceTable *table = &advance_tables[advance_table_count++];
+    table->font = font;
+    for (uint16_t c = 0; c < ADVANCE_TABLE_CHARS; c++) {
+        FGlyph *glyph = ffont_glyph_info(font, c);
+        table->advance[c] = glyph ? glyph->horiz_adv_x : 0;
+    }
+}
+
+/**
+ * Build the advance tables of the loaded fonts that do not have one yet (the weather font may be loaded after the
+ * first frame).
+ */
+void advance_tables_create() {
+    advance_table_add(font_main);
+    advance_table_add(font_weather);
+}
+
+/**
+ * Forget the advance tables (e.g., when the fonts are unloaded).
+ */
+void advance_tables_destroy() {
+    advance_table_count = 0;
+}
+
+/**
+ * Sum up the advances of the characters in str, if there is a table for the font and it covers all characters.
+ */
+static bool advance_table_lookup(char *str, FFont *font, int32_t *advance) {
+    const AdvanceTable *table = advance_table_find(font);
+    if (table == NULL) return false;
+
+    int32_t result = 0;
+    for (const uint8_t *s = (const uint8_t *) str; *s; s++) {
+        uint16_t c = *s;
+        if (c >= 0x80) {
+            // only two byte UTF-8 sequences can be in the table
+            if ((c & 0xe0) != 0xc0 || (s[1] & 0xc0) != 0x80) return false;
+            c = (uint16_t) (((c & 0x1f) << 6) | (s[1] & 0x3f));
+            s++;
+            if (c >= ADVANCE_TABLE_CHARS) return false;
+        }
+        result += table->advance[c];
+    }
+    *advance = result;
+    return true;
+}
+#else
+// bitmap fonts are measured with the layout call: their glyph advances are not known to add up to the laid out width
+void advance_tables_create() {
+}
+
+void advance_tables_destroy() {
+}
+#endif
+
 #ifdef PBL_COLOR
 fixed_t string_width(FContext *fctx, char *str, FFont *font, int size)
 #else
@@ -24,6 +107,11 @@ fixed_t string_width(FContext *fctx, char *str, GFont font, int size)
 {
     if (str[0] == 0) return 0;
 #ifdef PBL_COLOR
+    int32_t advance;
+    if (advance_table_lookup(str, font, &advance)) {
+        // the same scaling as fctx_string_width
+        return FIXED_TO_INT((int64_t) advance * INT_TO_FIXED(size) / font->units_per_em);
+    }
     fctx_set_text_em_height(fctx, font, size);
     return FIXED_TO_INT(fctx_string_width(fctx, str, font));
 #else
@@ -62,19 +150,258 @@ void draw_string(FContext *fctx, char *str, GPoint position, GFont font, GColor
 }
 #endif
 
+/** Slots of the text cache, one for every group of strings that is drawn in each frame. */
+#define TEXT_CACHE_DATE 0
+#define TEXT_CACHE_WEATHER 1
+#define TEXT_CACHE_SLOTS 2
+/** The most strings in one group. */
+#define TEXT_CACHE_STRINGS 2
+
+/** A string to be drawn with draw_cached_strings, the arguments are as for draw_string. */
+typedef struct {
+    char *str;
+    GPoint position;
+#ifdef PBL_COLOR
+    FFont *font;
+#else
+    GFont font;
+#endif
+    GColor color;
+    int size;
+    bool center;
+} CachedString;
 
-void draw_pointer(GContext *ctx, GPoint target, int16_t width, int16_t height, int32_t angle, GColor color) {
-    GPoint vertices[3];
-    vertices[0].x = 0;
-    vertices[0].y = 0;
-    vertices[1].x = -width / 2;
-    vertices[1].y = height;
-    vertices[2].x = width / 2;
-    vertices[2].y = height;
-    GPathInfo T;
-    T.num_points = 3;
-    T.points = vertices;
-    GPath *triangle = gpath_create(&T);
+#ifdef PBL_COLOR
+/**
+ * A group of strings as drawn by draw_string on a plain background, together with everything the pixels depend on.
+ * The positions of the strings and the box are relative to the position of the first string.
+ */
+typedef struct {
+    bool valid;
+    uint8_t count;
+    struct {
+        char str[30];
+        GPoint position;
+        FFont *font;
+        uint8_t color;
+        int16_t size;
+        bool center;
+    } strings[TEXT_CACHE_STRINGS];
+    uint8_t background;
+    GRect box;
+    uint8_t *pixels;
+    uint16_t capacity;
+} TextCacheEntry;
+
+static TextCacheEntry text_cache[TEXT_CACHE_SLOTS];
+
+/** Size of the pixel buffer of each slot (enough for the longest date and weather strings with their margins). */
+static const uint16_t text_cache_capacity[TEXT_CACHE_SLOTS] = {
+        SCALED_EMERY(PBL_IF_ROUND_ELSE(4400, 3600)),
+        SCALED_EMERY(PBL_IF_ROUND_ELSE(3600, 2800)),
+};
+
+/**
+ * The box (in screen coordinates) that contains all pixels of a string, with some room to spare.
+ */
+static GRect text_cache_box(FContext *fctx, const CachedString *string) {
+    FFont *font = string->font;
+    const int size = string->size;
+    const int16_t w = (int16_t) string_width(fctx, string->str, font, size);
+    const int16_t margin = (int16_t) (size / 8 + 2);
+    const int16_t top = (int16_t) ((font->ascent - font->cap_height) * size / font->units_per_em + margin);
+    const int16_t bottom = (int16_t) ((font->cap_height - font->descent) * size / font->units_per_em + margin);
+    // relative to the anchor used in draw_string
+    const int16_t x = (int16_t) (string->position.x + width / 2 + (string->center ? -w / 2 : 0) - margin);
+    const int16_t y = (int16_t) (string->position.y + 5 - top);
+    return GRect(x, y, w + 2 * margin, top + bottom);
+}
+
+/**
+ * Check that a box of the frame buffer is visible and has a single color, which is stored in background.  With
+ * border_only, only the outermost pixels of the box are checked (against the given background).
+ */
+static bool frame_buffer_box_is_plain(GBitmap *frame_buffer, GRect box, bool border_only, uint8_t *background) {
+    const GRect screen = gbitmap_get_bounds(frame_buffer);
+    if (box.origin.y < 0 || box.origin.y + box.size.h > screen.size.h || box.size.w <= 0) return false;
+    const int16_t x0 = box.origin.x;
+    const int16_t x1 = box.origin.x + box.size.w - 1;
+    bool first = !border_only;
+    for (int16_t y = box.origin.y; y < box.origin.y + box.size.h; y++) {
+        GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, y);
+        if (x0 < info.min_x || x1 > info.max_x) return false;
+        if (first) {
+            *background = info.data[x0];
+            first = false;
+        }
+        if (border_only && y != box.origin.y && y != box.origin.y + box.size.h - 1) {
+            if (info.data[x0] != *background || info.data[x1] != *background) return false;
+            continue;
+        }
+        for (int16_t x = x0; x <= x1; x++) {
+            if (info.data[x] != *background) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Copy a box of the frame buffer into a cache entry, or the entry back into the frame buffer if restore is set.
+ */
+static void copy_text_cache(GBitmap *frame_buffer, GRect box, TextCacheEntry *entry, bool restore) {
+    for (int16_t y = 0; y < box.size.h; y++) {
+        GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, box.origin.y + y);
+        uint8_t *screen_row = &info.data[box.origin.x];
+        uint8_t *cache_row = &entry->pixels[y * box.size.w];
+        if (restore) {
+            memcpy(screen_row, cache_row, box.size.w);
+        } else {
+            memcpy(cache_row, screen_row, box.size.w);
+        }
+    }
+}
+
+/**
+ * Does the cache entry hold exactly these strings (relative to the first one), on the given background?
+ */
+static bool text_cache_matches(const TextCacheEntry *entry, const CachedString *strings, uint8_t count,
+                               uint8_t background) {
+    if (!entry->valid || entry->count != count || entry->background != background) return false;
+    for (uint8_t i = 0; i < count; i++) {
+        const CachedString *string = &strings[i];
+        if (entry->strings[i].font != string->font || entry->strings[i].color != string->color.argb ||
+            entry->strings[i].size != string->size || entry->strings[i].center != string->center ||
+            entry->strings[i].position.x != string->position.x - strings[0].position.x ||
+            entry->strings[i].position.y != string->position.y - strings[0].position.y ||
+            strcmp(entry->strings[i].str, string->str) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Remember the strings (and the pixels in the box) in a cache entry.
+ */
+static void text_cache_store(TextCacheEntry *entry, GBitmap *frame_buffer, GRect box, const CachedString *strings,
+                             uint8_t count, uint8_t background) {
+    // the buffers are allocated up front, so strings that do not fit are just not cached
+    if (entry->pixels == NULL || box.size.w * box.size.h > entry->capacity) return;
+    copy_text_cache(frame_buffer, box, entry, false);
+    entry->count = count;
+    for (uint8_t i = 0; i < count; i++) {
+        const CachedString *string = &strings[i];
+        strcpy(entry->strings[i].str, string->str);
+        entry->strings[i].position = GPoint(string->position.x - strings[0].position.x,
+                                            string->position.y - strings[0].position.y);
+        entry->strings[i].font = string->font;
+        entry->strings[i].color = string->color.argb;
+        entry->strings[i].size = (int16_t) string->size;
+        entry->strings[i].center = string->center;
+    }
+    entry->background = background;
+    entry->valid = true;
+}
+#endif
+
+/**
+ * Draw a group of strings like draw_string, but keep the result in a slot of the text cache.  As long as the
+ * strings, fonts, colors, sizes and relative positions stay the same and they are drawn on the same plain
+ * background, the pixels are just copied to the new position instead of rasterizing the outlines again.
+ */
+static void draw_cached_strings(FContext *fctx, GContext *ctx, uint8_t slot, const CachedString *strings,
+                                uint8_t count) {
+#ifdef PBL_COLOR
+    TextCacheEntry *entry = &text_cache[slot];
+    GRect box = text_cache_box(fctx, &strings[0]);
+    bool cacheable = count <= TEXT_CACHE_STRINGS;
+    for (uint8_t i = 0; i < count; i++) {
+        if (strlen(strings[i].str) >= sizeof(entry->strings[i].str)) cacheable = false;
+        if (i > 0) {
+            // extend the box to cover this string, too
+            const GRect other = text_cache_box(fctx, &strings[i]);
+            const int16_t x0 = other.origin.x < box.origin.x ? other.origin.x : box.origin.x;
+            const int16_t y0 = other.origin.y < box.origin.y ? other.origin.y : box.origin.y;
+            const int16_t x1 = other.origin.x + other.size.w > box.origin.x + box.size.w ?
+                               other.origin.x + other.size.w : box.origin.x + box.size.w;
+            const int16_t y1 = other.origin.y + other.size.h > box.origin.y + box.size.h ?
+                               other.origin.y + other.size.h : box.origin.y + box.size.h;
+            box = GRect(x0, y0, x1 - x0, y1 - y0);
+        }
+    }
+
+    uint8_t background;
+    bool plain = false;
+    GBitmap *frame_buffer = cacheable ? graphics_capture_frame_buffer(ctx) : NULL;
+    if (frame_buffer) {
+        plain = frame_buffer_box_is_plain(frame_buffer, box, false, &background);
+        if (plain && text_cache_matches(entry, strings, count, background)) {
+            copy_text_cache(frame_buffer, box, entry, true);
+            graphics_release_frame_buffer(ctx, frame_buffer);
+            return;
+        }
+        graphics_release_frame_buffer(ctx, frame_buffer);
+    }
+#endif
+
+    for (uint8_t i = 0; i < count; i++) {
+        draw_string(fctx, strings[i].str, strings[i].position, strings[i].font, strings[i].color, strings[i].size,
+                    strings[i].center);
+    }
+
+#ifdef PBL_COLOR
+    if (!plain) return;
+    // remember the result, unless some pixels ended up outside of the box
+    entry->valid = false;
+    frame_buffer = graphics_capture_frame_buffer(ctx);
+    if (frame_buffer == NULL) return;
+    if (frame_buffer_box_is_plain(frame_buffer, box, true, &background)) {
+        text_cache_store(entry, frame_buffer, box, strings, count, background);
+    }
+    graphics_release_frame_buffer(ctx, frame_buffer);
+#endif
+}
+
+/**
+ * Allocate the pixel buffers of the text cache.
+ */
+static void text_cache_create() {
+#ifdef PBL_COLOR
+    for (uint8_t i = 0; i < TEXT_CACHE_SLOTS; i++) {
+        text_cache[i] = (TextCacheEntry) {0};
+        text_cache[i].pixels = malloc(text_cache_capacity[i]);
+        text_cache[i].capacity = text_cache[i].pixels ? text_cache_capacity[i] : (uint16_t) 0;
+    }
+#endif
+}
+
+/**
+ * Free the text cache.
+ */
+static void text_cache_destroy() {
+#ifdef PBL_COLOR
+    for (uint8_t i = 0; i < TEXT_CACHE_SLOTS; i++) {
+        free(text_cache[i].pixels);
+        text_cache[i] = (TextCacheEntry) {0};
+    }
+#endif
+}
+
+
+/**
+ * The seconds pointer, a triangle with its tip at the origin (created once in drawing_create).
+ */
+static GPoint pointer_points[3] = {
+        {0, 0},
+        {-PBL_IF_ROUND_ELSE(12, 10) / 2, PBL_IF_ROUND_ELSE(14, 12)},
+        {PBL_IF_ROUND_ELSE(12, 10) / 2, PBL_IF_ROUND_ELSE(14, 12)},
+};
+static GPathInfo pointer_path_info = {3, pointer_points};
+static GPath *pointer_path = NULL;
+
+static void draw_pointer(GContext *ctx, GPoint target, int32_t angle, GColor color) {
+    GPath *triangle = pointer_path;
+    if (triangle == NULL) return;
 
     gpath_rotate_to(triangle, angle);
     gpath_move_to(triangle, target);
@@ -87,8 +414,6 @@ void draw_pointer(GContext *ctx, GPoint target, int16_t width, int16_t height, i
     graphics_context_set_stroke_color(ctx, color);
     gpath_draw_outline(ctx, triangle);
 
-    gpath_destroy(triangle);
-
     graphics_context_set_stroke_color(ctx, COLOR(config_color_ticks));
     graphics_context_set_fill_color(ctx, COLOR(config_color_ticks));
 }
@@ -218,7 +543,7 @@ int debug_iter = 0;
 #endif
 
 /** Array of candidate points to draw the weather string at */
-static GPoint w_points[] = {
+static const GPoint w_points[] = {
         {SCALED_EMERY(0),                            SCALED_EMERY(0)},
         {SCALED_EMERY(10 + PBL_IF_ROUND_ELSE(2, 0)), SCALED_EMERY(3)},
         {SCALED_EMERY(17 + PBL_IF_ROUND_ELSE(3, 0)), SCALED_EMERY(7)},
@@ -229,7 +554,7 @@ static GPoint w_points[] = {
         {SCALED_EMERY(33 + PBL_IF_ROUND_ELSE(6, 0)), SCALED_EMERY(39)},
 };
 /** Array of candidate points to draw the date string at */
-static GPoint d_points[] = {
+static const GPoint d_points[] = {
         {SCALED_EMERY(0),  SCALED_EMERY(16)},
         {SCALED_EMERY(10), SCALED_EMERY(16 - 3)},
         {SCALED_EMERY(17), SCALED_EMERY(16 - 7)},
@@ -265,38 +590,258 @@ void remove_leading_zero(char *buffer, size_t length) {
     }
 }
 
+/** The formatted date strings, and what they were formatted from (see format_date). */
+static char date_buffer_1[30];
+static char date_buffer_2[30];
+static bool date_buffers_valid = false;
+static uint8_t date_buffers_format;
+static uint8_t date_buffers_depends;
+static struct tm date_buffers_time;
+
+/** Fields of the time a date format depends on. */
+#define DATE_DEPENDS_DAY 1
+#define DATE_DEPENDS_TIME 2
+/** The names of days or months (everything else is digits). */
+#define DATE_DEPENDS_NAMES 4
+
 /**
- * Update procedure for the background
+ * Which fields of the time (day or hour and minute) are shown by a strftime format.
  */
-void background_update_proc(Layer *layer, GContext *ctx) {
+static uint8_t date_format_depends(const char *format) {
+    uint8_t depends = 0;
+    for (; format != NULL && *format != 0; format++) {
+        if (*format != '%' || format[1] == 0) continue;
+        format++;
+        if (*format == 'H' || *format == 'I' || *format == 'M') {
+            depends |= DATE_DEPENDS_TIME;
+        } else {
+            depends |= DATE_DEPENDS_DAY;
+        }
+        if (*format == 'a' || *format == 'b') {
+            depends |= DATE_DEPENDS_NAMES;
+        }
+    }
+    return depends;
+}
+
+/**
+ * The strftime formats of a date format: format_1 for the date, format_2 for the first line of two-line formats (or
+ * NULL).
+ */
+static void date_format_strings(uint8_t date_format, char **format_1, char **format_2) {
+    *format_1 = NULL;
+    *format_2 = NULL;
+    switch (date_format) {
+        case 0: // Mon // Oct 22 (date)
+            *format_1 = "%b %d";
+            *format_2 = "%a";
+            break;
+        case 1: // Oct 22 (date)
+            *format_1 = "%b %d";
+            break;
+        case 2: // 10/22 (date)
+            *format_1 = "%m/%d";
+            break;
+        case 3: // 22.10. (date)
+            *format_1 = "%d.%m.";
+            break;
+        case 4: // 22 (date)
+            *format_1 = "%d";
+            break;
+        case 5: // Mon 22 (date)
+            *format_1 = "%a %d";
+            break;
+        case 6: // Mon (day)
+            *format_1 = "%a";
+            break;
+        case 7: // 14:10 (time 24h)
+            *format_1 = "%H:%M";
+            break;
+        case 8: // 2:10 (time 12h)
+            *format_1 = "%I:%M";
+            break;
+        case 9: // 2:10 // 10/22 (date/time)
+            *format_1 = "%m/%d";
+            *format_2 = "%I:%M";
+            break;
+        case 10: // 14:10 // 10/22 (date/time)
+            *format_1 = "%m/%d";
+            *format_2 = "%H:%M";
+            break;
+        case 11: // Mon // 10/22 (date/time)
+            *format_1 = "%m/%d";
+            *format_2 = "%a";
+            break;
+        case 12: // 2:10 // 22.10. (date/time)
+            *format_1 = "%d.%m.";
+            *format_2 = "%I:%M";
+            break;
+        case 13: // 14:10 // 22.10. (date/time)
+            *format_1 = "%d.%m.";
+            *format_2 = "%H:%M";
+            break;
+        case 14: // Mon // 22.10. (date/time)
+            *format_1 = "%d.%m.";
+            *format_2 = "%a";
+            break;
+        case 15: // 2:10 | Mon 22 (date/time)
+            *format_1 = "%a %d";
+            *format_2 = "%I:%M";
+            break;
+        case 16: // 14:10 | Mon 22 (date/time)
+            *format_1 = "%a %d";
+            *format_2 = "%H:%M";
+            break;
+        case 17: // Mon // 22 Oct (date)
+            *format_1 = "%d %b";
+            *format_2 = "%a";
+            break;
+    }
+}
+
+/**
+ * Does a date format show names of days or months (in the current locale), or only digits?
+ */
+bool date_format_shows_names(uint8_t date_format) {
+    char *format_1;
+    char *format_2;
+    date_format_strings(date_format, &format_1, &format_2);
+    return ((date_format_depends(format_1) | date_format_depends(format_2)) & DATE_DEPENDS_NAMES) != 0;
+}
+
+/**
+ * Format the date strings for the current date format into date_buffer_1 (the date) and date_buffer_2 (the first
+ * line of two-line formats, or empty).  The strings are only formatted again if the format changed or one of the
+ * fields of t it shows, so that date-only formats are formatted once a day.
+ */
+static void format_date(struct tm *t) {
+    if (date_buffers_valid && date_buffers_format == config_date_format &&
+        (!(date_buffers_depends & DATE_DEPENDS_DAY) || (date_buffers_time.tm_yday == t->tm_yday &&
+                                                        date_buffers_time.tm_year == t->tm_year)) &&
+        (!(date_buffers_depends & DATE_DEPENDS_TIME) || (date_buffers_time.tm_hour == t->tm_hour &&
+                                                         date_buffers_time.tm_min == t->tm_min))) {
+        return;
+    }
+
+    char *format_1;
+    char *format_2;
+    date_format_strings(config_date_format, &format_1, &format_2);
+
+    setlocale(LC_ALL, "");
+    strftime(date_buffer_1, sizeof(date_buffer_1), format_1, t);
+    if (format_2 == NULL) {
+        date_buffer_2[0] = 0;
+    } else {
+        strftime(date_buffer_2, sizeof(date_buffer_2), format_2, t);
+    }
+    // remove leading zeros
+    if (config_date_format != 7) {
+        remove_leading_zero(date_buffer_1, sizeof(date_buffer_1));
+        remove_leading_zero(date_buffer_2, sizeof(date_buffer_2));
+    }
 
-    // initialize fctx
-    FContext fctx;
-    fctx_init_context(&fctx, ctx);
+    date_buffers_valid = true;
+    date_buffers_format = config_date_format;
+    date_buffers_depends = date_format_depends(format_1) | date_format_depends(format_2);
+    date_buffers_time = *t;
+}
 
-//    APP_LOG(APP_LOG_LEVEL_DEBUG, "drawing...");
+/**
+ * Everything a placement search (for the date, weather or battery) depends on: the position of the hands, the
+ * bounds and the size of what is placed.
+ */
+typedef struct {
+    uint8_t minute;
+    uint8_t hour_tick;
+    GRect bounds;
+    int16_t size[3];
+} PlacementKey;
+
+/** The result of a placement search: the chosen candidate, or -1 for the default position. */
+typedef struct {
+    bool valid;
+    PlacementKey key;
+    int16_t index;
+} Placement;
+
+static Placement placement_date;
+static Placement placement_weather;
+#ifdef PBL_ROUND
+static Placement placement_battery;
+#endif
 
-    // update bounds
+/** The unobstructed bounds that center, width and height were computed from. */
+static GRect face_bounds;
+
+/**
+ * Build the key for a placement search.
+ */
+static PlacementKey placement_key(int minute, int hour_tick, int16_t size_0, int16_t size_1, int16_t size_2) {
+    return (PlacementKey) {
+            .minute = (uint8_t) minute,
+            .hour_tick = (uint8_t) hour_tick,
+            .bounds = face_bounds,
+            .size = {size_0, size_1, size_2},
+    };
+}
+
+/**
+ * Look up the result of a placement search, returns false if the search needs to run.
+ */
+static bool placement_lookup(const Placement *placement, const PlacementKey *key, int16_t *index) {
+    if (!placement->valid || placement->key.minute != key->minute || placement->key.hour_tick != key->hour_tick ||
+        !grect_equal(&placement->key.bounds, &key->bounds) || placement->key.size[0] != key->size[0] ||
+        placement->key.size[1] != key->size[1] || placement->key.size[2] != key->size[2]) {
+        return false;
+    }
+    *index = placement->index;
+    return true;
+}
+
+/**
+ * Remember the result of a placement search.
+ */
+static void placement_store(Placement *placement, const PlacementKey *key, int16_t index) {
+    placement->valid = true;
+    placement->key = *key;
+    placement->index = index;
+}
+
+/**
+ * Candidate i of a placement search: the points are tried alternately mirrored (for even i) and as they are.
+ * The index -1 is the default position.
+ */
+static GPoint placement_candidate(const GPoint *points, int16_t i) {
+    GPoint result = points[(i + 1) / 2];
+    if (i % 2 == 0) {
+        result.x = -result.x;
+    }
+    return result;
+}
+
+/**
+ * The point of the face at an offset from the center (see Geometry).
+ */
+static inline GPoint geometry_point(const GeometryOffset offset) {
+    return GPoint(center.x + offset.x, center.y + offset.y);
+}
+
+/**
+ * Update the center, width and height of the watch from the unobstructed bounds.
+ */
+static void update_bounds() {
     GRect bounds = layer_get_unobstructed_bounds(layer_background);
+    face_bounds = bounds;
     center = grect_center_point(&bounds);
     height = bounds.size.h;
     width = bounds.size.w;
+    update_geometry(bounds);
+}
 
-    int16_t radius = width / 2;
-    bool bluetooth = bluetooth_connection_service_peek();
-#ifdef DEBUG_NO_BLUETOOTH
-    bluetooth = false;
-#endif
-    BatteryChargeState battery_state = battery_state_service_peek();
-#ifdef SCREENSHOT_BATTERY_LOW_1
-    battery_state.charge_percent = 30;
-#endif
-#ifdef SCREENSHOT_BATTERY_LOW_2
-    battery_state.charge_percent = 20;
-#endif
-#ifdef SCREENSHOT_BATTERY_LOW_3
-    battery_state.charge_percent = 10;
-#endif
+/**
+ * The current time (possibly modified for screenshots and debugging).
+ */
+static struct tm *current_time() {
     time_t now = time(NULL);
     struct tm *t = localtime(&now);
 
@@ -311,11 +856,6 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     t->tm_year = 2015;
     t->tm_wday = 6;
 #endif
-#ifdef DEBUG_NICE_WEATHER
-    weather.timestamp = now;
-    weather.icon = (uint8_t)'a';
-    weather.temperature = 74;
-#endif
 #ifdef SCREENSHOT_DATE_1
     t->tm_min = 26;
     t->tm_hour = 10;
@@ -324,27 +864,86 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     t->tm_min = 31;
     t->tm_hour = 0;
 #endif
-#ifdef SCREENSHOT_WEATHER_1
-    weather.icon = (uint8_t)'B';
-    weather.temperature = 59;
+    return t;
+}
+
+/** The battery state (see set_battery_state), and its tier: 0 (charging or above 30%), 1 (30%), 2 (20%), 3 (10%). */
+static BatteryChargeState battery_state;
+static uint8_t battery_tier;
+
+/**
+ * Is the weather shown (turned on, available and not expired)?
+ */
+bool weather_is_visible() {
+    return config_weather_refresh > 0 && weather_is_current(time(NULL));
+}
+
+/**
+ * Does the face draw anything in the weather font right now (the weather, or the bluetooth logo on round watches)?
+ */
+bool weather_font_needed() {
+#ifdef PBL_ROUND
+    if (config_bluetooth_logo && !bluetooth_connection_service_peek()) return true;
 #endif
-#ifdef SCREENSHOT_WEATHER_2
-    weather.icon = (uint8_t)'h';
-    weather.temperature = -12;
+    return weather_is_visible();
+}
+
+/**
+ * Remember a new battery state (possibly modified for screenshots).  Returns whether anything shown on the face
+ * depends on the change: the tier, charging or plugged, or the 10% steps of the battery icon.
+ */
+bool set_battery_state(BatteryChargeState state) {
+#ifdef SCREENSHOT_BATTERY_LOW_1
+    state.charge_percent = 30;
+#endif
+#ifdef SCREENSHOT_BATTERY_LOW_2
+    state.charge_percent = 20;
 #endif
+#ifdef SCREENSHOT_BATTERY_LOW_3
+    state.charge_percent = 10;
+#endif
+    uint8_t tier = 0;
+    if (!state.is_charging && !state.is_plugged) {
+        if (state.charge_percent <= 10) {
+            tier = 3;
+        } else if (state.charge_percent <= 20) {
+            tier = 2;
+        } else if (state.charge_percent <= 30) {
+            tier = 1;
+        }
+    }
+    const bool changed = tier != battery_tier || state.is_charging != battery_state.is_charging ||
+                         state.is_plugged != battery_state.is_plugged ||
+                         state.charge_percent / 10 != battery_state.charge_percent / 10;
+    battery_state = state;
+    battery_tier = tier;
+    return changed;
+}
+
+/**
+ * Pick the color for the current battery tier.
+ */
+static uint8_t battery_tier_color(uint8_t color, uint8_t color_30, uint8_t color_20, uint8_t color_10) {
+    switch (battery_tier) {
+        case 1:
+            return color_30;
+        case 2:
+            return color_20;
+        case 3:
+            return color_10;
+        default:
+            return color;
+    }
+}
 
+/**
+ * Draw the static part of the face: background, ring and ticks.
+ */
+static void draw_background(Layer *layer, GContext *ctx, uint8_t background_color, struct tm *t) {
     // background
 #ifndef PBL_ROUND
     if (!config_square) {
-        uint8_t outer_color = config_color_outer_background;
-        if (battery_state.charge_percent <= 10 && !battery_state.is_charging && !battery_state.is_plugged) {
-            outer_color = config_color_battery_bg_10;
-        } else if (battery_state.charge_percent <= 20 && !battery_state.is_charging && !battery_state.is_plugged) {
-            outer_color = config_color_battery_bg_20;
-        } else if (battery_state.charge_percent <= 30 && !battery_state.is_charging && !battery_state.is_plugged) {
-            outer_color = config_color_battery_bg_30;
-        }
-        graphics_context_set_fill_color(ctx, COLOR(outer_color));
+        graphics_context_set_fill_color(ctx, COLOR(background_color));
         graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
     } else {
         graphics_context_set_fill_color(ctx, COLOR(config_color_inner_background));
@@ -367,21 +966,14 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     // background
 #if !defined(PBL_ROUND)
     if (!config_square) {
+        const int16_t radius = width / 2;
         graphics_context_set_fill_color(ctx, COLOR(config_color_circle));
         graphics_fill_circle(ctx, center, (uint16_t) (radius + 3 + 2));
         graphics_context_set_fill_color(ctx, COLOR(config_color_inner_background));
         graphics_fill_circle(ctx, center, (uint16_t) radius);
     }
 #else
-    uint8_t inner_color = config_color_inner_background;
-    if (battery_state.charge_percent <= 10 && !battery_state.is_charging && !battery_state.is_plugged) {
-        inner_color = config_color_battery_bg_10;
-    } else if (battery_state.charge_percent <= 20 && !battery_state.is_charging && !battery_state.is_plugged) {
-        inner_color = config_color_battery_bg_20;
-    } else if (battery_state.charge_percent <= 30 && !battery_state.is_charging && !battery_state.is_plugged) {
-        inner_color = config_color_battery_bg_30;
-    }
-    graphics_context_set_fill_color(ctx, COLOR(inner_color));
+    graphics_context_set_fill_color(ctx, COLOR(background_color));
     graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
 #endif
 
@@ -431,6 +1023,7 @@ void background_update_proc(Layer *layer, GContext *ctx) {
 #endif
 
     // hour ticks
+    PROFILE_STAGE("ticks");
     graphics_context_set_stroke_color(ctx, COLOR(config_color_ticks));
     uint8_t tick_width = 2;
     if (config_hour_ticks != 3) {
@@ -438,71 +1031,230 @@ void background_update_proc(Layer *layer, GContext *ctx) {
             for (int i = 0; i < 12; ++i) {
                 if (config_hour_ticks == 2 && (i % 3) != 0) continue;
 
-                int32_t angle = i * TRIG_MAX_ANGLE / 12;
-                int tick_length = PBL_IF_ROUND_ELSE(8, 6);
-#ifdef OBSIDIAN_LONG_TICKS
-                if (i % 3 == 0) {
-                    tick_length = PBL_IF_ROUND_ELSE(12, 10);
-#ifdef OBSIDIAN_FAT_TICKS
-                    tick_width = 4;
-                } else {
-                    tick_width = 2;
-#endif
-                }
+#if defined(OBSIDIAN_LONG_TICKS) && defined(OBSIDIAN_FAT_TICKS)
+                tick_width = i % 3 == 0 ? 4 : 2;
 #endif
 
-                graphics_draw_line_with_width(ctx, get_radial_point(radius + PBL_IF_ROUND_ELSE(3, 0), angle),
-                                              get_radial_point(radius - tick_length, angle),
-                                              tick_width);
+                const GeometryOffset *tick = geometry->hour_ticks[i];
+                graphics_draw_line_with_width(ctx, geometry_point(tick[0]), geometry_point(tick[1]), tick_width);
             }
         } else {
             for (int i = 0; i < 12; ++i) {
                 if (config_hour_ticks == 2 && (i % 3) != 0) continue;
-                int32_t angle = i * TRIG_MAX_ANGLE / 12;
-                int tick_length = (i % 3 == 0) ? 12 : 8;
-                int tick_width = 4;
-                graphics_draw_line_with_width(ctx, get_radial_border_point(0, angle),
-                                          get_radial_border_point(tick_length, angle), tick_width);
+                const GeometryOffset *tick = geometry->hour_ticks[i];
+                graphics_draw_line_with_width(ctx, geometry_point(tick[0]), geometry_point(tick[1]), 4);
             }
         }
     }
 
     // minute ticks
-    int square_minute_tick = 4;
     if (config_minute_ticks == 2) {
         // only relevant minute ticks
         int start_min_tick = (t->tm_min / 5) * 5;
         for (int i = start_min_tick; i < start_min_tick + 5; ++i) {
-            int32_t angle = i * TRIG_MAX_ANGLE / 60;
-            if (!config_square) {
-                graphics_draw_line_with_width(ctx, get_radial_point(radius + PBL_IF_ROUND_ELSE(3, 0), angle),
-                                              get_radial_point(radius - PBL_IF_ROUND_ELSE(5, 3), angle), 1);
-            } else {
-                graphics_draw_line_with_width(ctx, get_radial_border_point(0, angle),
-                                              get_radial_border_point(square_minute_tick, angle), 1);
-            }
+            const GeometryOffset *tick = geometry->minute_ticks[i];
+            graphics_draw_line_with_width(ctx, geometry_point(tick[0]), geometry_point(tick[1]), 1);
         }
     } else if (config_minute_ticks == 1) {
         // all minute ticks
         for (int i = 0; i < 60; ++i) {
-            int32_t angle = i * TRIG_MAX_ANGLE / 60;
-            if (!config_square) {
-                graphics_draw_line_with_width(ctx, get_radial_point(radius + PBL_IF_ROUND_ELSE(3, 0), angle),
-                                              get_radial_point(radius - PBL_IF_ROUND_ELSE(5, 3), angle), 1);
-            } else {
-                graphics_draw_line_with_width(ctx, get_radial_border_point(0, angle),
-                                              get_radial_border_point(square_minute_tick, angle), 1);
-            }
+            const GeometryOffset *tick = geometry->minute_ticks[i];
+            graphics_draw_line_with_width(ctx, geometry_point(tick[0]), geometry_point(tick[1]), 1);
         }
     }
+}
+
+
+/** Copy of the static part of the face, or NULL if it is not allocated. */
+static GBitmap *background_cache;
+
+/** Is the content of the cache up to date?  The inputs it was drawn for are stored below. */
+static bool background_cache_valid;
+static GRect background_cache_bounds;
+static uint8_t background_cache_color;
+static int background_cache_minute_block;
+
+/** Extent of the seconds pointer around its target, including the outline. */
+#define SECONDS_POINTER_EXTENT PBL_IF_ROUND_ELSE(17, 15)
+#define SECONDS_BOX_SIZE (2 * SECONDS_POINTER_EXTENT + 1)
+
+/** The components that changed since the last frame (COMPONENT_* flags), see mark_inputs_changed. */
+static uint16_t dirty_components = COMPONENT_ALL;
+/** Whether the current frame only moves the seconds pointer (decided in background_update_proc). */
+static bool seconds_only_frame = false;
+/** The box around the seconds pointer on screen, and what was there before the pointer was drawn. */
+static GRect seconds_box;
+static uint8_t seconds_save_under[SECONDS_BOX_SIZE * SECONDS_BOX_SIZE];
+static bool seconds_box_valid = false;
+/** The time (hour * 60 + minute) of the frame the pointer was drawn into. */
+static int seconds_box_minute = -1;
+
+/**
+ * Force the static part of the face to be redrawn (e.g., after a configuration change).
+ */
+void background_cache_invalidate() {
+    background_cache_valid = false;
+}
+
+/**
+ * Allocate the cache for a frame buffer of the size of the display.
+ */
+static void background_cache_create() {
+    background_cache = gbitmap_create_blank(GSize(PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT),
+                                            PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit));
+    background_cache_valid = false;
+}
+
+/**
+ * Free the cache.
+ */
+static void background_cache_destroy() {
+    if (background_cache) {
+        gbitmap_destroy(background_cache);
+        background_cache = NULL;
+    }
+    background_cache_valid = false;
+}
+
+/**
+ * Copy the frame buffer into the cache, or the cache back into the frame buffer if restore is set.
+ */
+static void copy_background_cache(GBitmap *frame_buffer, bool restore) {
+    uint8_t *cache_data = gbitmap_get_data(background_cache);
+    const uint16_t cache_bytes_per_row = gbitmap_get_bytes_per_row(background_cache);
+    const int16_t rows = gbitmap_get_bounds(frame_buffer).size.h;
+    for (int16_t y = 0; y < rows; y++) {
+#ifdef PBL_COLOR
+        // only copy the visible part of the row (relevant on round displays)
+        GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, y);
+        uint8_t *screen_row = &info.data[info.min_x];
+        uint8_t *cache_row = &cache_data[y * cache_bytes_per_row + info.min_x];
+        const size_t length = info.max_x - info.min_x + 1;
+#else
+        const uint16_t screen_bytes_per_row = gbitmap_get_bytes_per_row(frame_buffer);
+        uint8_t *screen_row = &gbitmap_get_data(frame_buffer)[y * screen_bytes_per_row];
+        uint8_t *cache_row = &cache_data[y * cache_bytes_per_row];
+        const size_t length = screen_bytes_per_row < cache_bytes_per_row ? screen_bytes_per_row : cache_bytes_per_row;
+#endif
+        if (restore) {
+            memcpy(screen_row, cache_row, length);
+        } else {
+            memcpy(cache_row, screen_row, length);
+        }
+    }
+}
+
+/**
+ * Update procedure for the background (the static part of the face).  The result is kept in an offscreen
+ * bitmap and only drawn again if the configuration, the bounds or the battery color change.
+ */
+void background_update_proc(Layer *layer, GContext *ctx) {
+    PROFILE_STAGE("background");
+    update_bounds();
+    struct tm *t = current_time();
+    const GRect bounds = layer_get_unobstructed_bounds(layer_background);
+    // the background changes when the battery runs low
+    const uint8_t background_color = battery_tier_color(
+            PBL_IF_ROUND_ELSE(config_color_inner_background, config_color_outer_background),
+            config_color_battery_bg_30, config_color_battery_bg_20, config_color_battery_bg_10);
+    // with only the relevant minute ticks, the face changes every 5 minutes
+    const int minute_block = config_minute_ticks == 2 ? t->tm_min / 5 : -1;
+
+    const bool cache_hit = background_cache_valid && background_cache_color == background_color &&
+                           background_cache_minute_block == minute_block &&
+                           grect_equal(&background_cache_bounds, &bounds);
+
+#ifdef OBSIDIAN_INCREMENTAL_SECONDS
+    // if only the seconds changed, the face is still on screen and hands_update_proc just moves the pointer
+    seconds_only_frame = dirty_components == COMPONENT_SECONDS && cache_hit && seconds_box_valid &&
+                         seconds_box_minute == t->tm_hour * 60 + t->tm_min;
+#endif
+    dirty_components = 0;
+    if (seconds_only_frame) return;
+
+    if (cache_hit) {
+        GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+        if (frame_buffer) {
+            copy_background_cache(frame_buffer, true);
+            graphics_release_frame_buffer(ctx, frame_buffer);
+            return;
+        }
+    }
+
+    draw_background(layer, ctx, background_color, t);
+
+    // remember what we have drawn
+    PROFILE_STAGE("background");
+    background_cache_valid = false;
+    GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+    if (frame_buffer == NULL) return;
+    if (background_cache) {
+        copy_background_cache(frame_buffer, false);
+        background_cache_valid = true;
+        background_cache_bounds = bounds;
+        background_cache_color = background_color;
+        background_cache_minute_block = minute_block;
+    }
+    graphics_release_frame_buffer(ctx, frame_buffer);
+}
+
+/**
+ * The position (in seconds) of the seconds pointer at time t.
+ */
+static int seconds_position(struct tm *t) {
+    return (t->tm_sec % 60) - (t->tm_sec % config_seconds);
+}
+
+/**
+ * The fctx context used by draw_hands; it is initialized on the first frame (when there is a graphics context) and
+ * kept until drawing_destroy.
+ */
+static FContext render_fctx;
+static bool render_fctx_valid = false;
+
+/**
+ * Draw everything that moves: seconds (if draw_seconds is set), date, weather, hands, battery and the bluetooth
+ * popup.
+ */
+static void draw_hands(Layer *layer, GContext *ctx, bool draw_seconds) {
+
+    // initialize fctx (once, the context is the same for every frame)
+    PROFILE_STAGE("setup");
+    if (!render_fctx_valid) {
+        fctx_init_context(&render_fctx, ctx);
+        render_fctx_valid = true;
+    }
+    render_fctx.gctx = ctx;
+    FContext *fctx = &render_fctx;
+
+    update_bounds();
+    bool bluetooth = bluetooth_connection_service_peek();
+#ifdef DEBUG_NO_BLUETOOTH
+    bluetooth = false;
+#endif
+    struct tm *t = current_time();
+
+#ifdef DEBUG_NICE_WEATHER
+    weather.timestamp = time(NULL);
+    weather.icon = (uint8_t)'a';
+    weather.temperature = 74;
+#endif
+#ifdef SCREENSHOT_WEATHER_1
+    weather.icon = (uint8_t)'B';
+    weather.temperature = 59;
+#endif
+#ifdef SCREENSHOT_WEATHER_2
+    weather.icon = (uint8_t)'h';
+    weather.temperature = -12;
+#endif
 
     // draw second hand
-    if (config_seconds != 0) {
-        int32_t angle = ((t->tm_sec % 60) - (t->tm_sec % config_seconds)) * TRIG_MAX_ANGLE / 60;
-        GPoint target = config_square ? get_radial_border_point(0, angle) : get_radial_point(
-                radius + PBL_IF_ROUND_ELSE(3, 0), angle);
-        draw_pointer(ctx, target, PBL_IF_ROUND_ELSE(12, 10),
-                     PBL_IF_ROUND_ELSE(14, 12), angle, COLOR(config_color_seconds));
+    PROFILE_STAGE("seconds");
+    if (config_seconds != 0 && draw_seconds) {
+        int second = seconds_position(t);
+        int32_t angle = second * TRIG_MAX_ANGLE / 60;
+        GPoint target = geometry_point(geometry->minute_ticks[second][0]);
+        draw_pointer(ctx, target, angle, COLOR(config_color_seconds));
     }
 
 #ifdef DEBUG_DATE_POSITION
@@ -526,7 +1278,7 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     int widest_num_tmp3 = 0;
     for (int i = 0; i < 10; i++) {
         snprintf(buffer_1, 10, "%d", i);
-        int w = string_width(&fctx, buffer_1, font_main, 18);
+        int w = string_width(fctx, buffer_1, font_main, 18);
         if (w > widest_num_tmp) {
             widest_num_tmp = w;
             widest_num = i;
@@ -545,14 +1297,14 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     int widest_month_int_tmp = 0;
     for (int i = 0; i < 12; i++) {
         snprintf(buffer_1, 10, "%s %d%d", months[i], widest_num3, widest_num);
-        int w = string_width(&fctx, buffer_1, font_main, 18);
+        int w = string_width(fctx, buffer_1, font_main, 18);
         if (w > widest_month_tmp) {
             widest_month_tmp = w;
             widest_month = months[i];
         }
 
         snprintf(buffer_1, 10, "%d/%d%d", i+1, widest_num3, widest_num);
-        w = string_width(&fctx, buffer_1, font_main, 18);
+        w = string_width(fctx, buffer_1, font_main, 18);
         if (w > widest_month_int_tmp) {
             widest_month_int_tmp = w;
             widest_month_int = i + 1;
@@ -562,102 +1314,23 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Widest number below 3: %d", widest_num3); // 1
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Widest month: %s (%d)", widest_month, widest_month_tmp); // May 10 at 51
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Widest month: %d (%d)", widest_month_int, widest_month_int_tmp); // 10/10 at 40
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "OK width: %d", (int)string_width(&fctx, "May 10", font_main, 20)); // 57
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "OK width: %d", (int)string_width(&fctx, "10/10", font_main, 24));
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "OK width: %d", (int)string_width(&fctx, "10:10", font_main, 24));
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "OK width: %d", (int)string_width(fctx, "May 10", font_main, 20)); // 57
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "OK width: %d", (int)string_width(fctx, "10/10", font_main, 24));
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "OK width: %d", (int)string_width(fctx, "10:10", font_main, 24));
 #endif
 
     // compute angles
-    int32_t minute_angle = t->tm_min * TRIG_MAX_ANGLE / 60;
-    GPoint minute_hand = get_radial_point(radius - PBL_IF_ROUND_ELSE(16, 10), minute_angle);
+    PROFILE_STAGE("date");
+    GPoint minute_hand = geometry_point(geometry->minute_hand[t->tm_min][0]);
     int hour_tick = ((t->tm_hour % 12) * 6) + (t->tm_min / 10);
-    int32_t hour_angle = hour_tick * TRIG_MAX_ANGLE / (12 * 6);
-    GPoint hour_hand = get_radial_point(radius * 55 / 100, hour_angle);
+    GPoint hour_hand = geometry_point(geometry->hour_hand[hour_tick][0]);
 
-    // format date strings
-    char *format_1 = NULL;
-    char *format_2 = NULL;
-    switch (config_date_format) {
-        case 0: // Mon // Oct 22 (date)
-            format_1 = "%b %d";
-            format_2 = "%a";
-            break;
-        case 1: // Oct 22 (date)
-            format_1 = "%b %d";
-            break;
-        case 2: // 10/22 (date)
-            format_1 = "%m/%d";
-            break;
-        case 3: // 22.10. (date)
-            format_1 = "%d.%m.";
-            break;
-        case 4: // 22 (date)
-            format_1 = "%d";
-            break;
-        case 5: // Mon 22 (date)
-            format_1 = "%a %d";
-            break;
-        case 6: // Mon (day)
-            format_1 = "%a";
-            break;
-        case 7: // 14:10 (time 24h)
-            format_1 = "%H:%M";
-            break;
-        case 8: // 2:10 (time 12h)
-            format_1 = "%I:%M";
-            break;
-        case 9: // 2:10 // 10/22 (date/time)
-            format_1 = "%m/%d";
-            format_2 = "%I:%M";
-            break;
-        case 10: // 14:10 // 10/22 (date/time)
-            format_1 = "%m/%d";
-            format_2 = "%H:%M";
-            break;
-        case 11: // Mon // 10/22 (date/time)
-            format_1 = "%m/%d";
-            format_2 = "%a";
-            break;
-        case 12: // 2:10 // 22.10. (date/time)
-            format_1 = "%d.%m.";
-            format_2 = "%I:%M";
-            break;
-        case 13: // 14:10 // 22.10. (date/time)
-            format_1 = "%d.%m.";
-            format_2 = "%H:%M";
-            break;
-        case 14: // Mon // 22.10. (date/time)
-            format_1 = "%d.%m.";
-            format_2 = "%a";
-            break;
-        case 15: // 2:10 | Mon 22 (date/time)
-            format_1 = "%a %d";
-            format_2 = "%I:%M";
-            break;
-        case 16: // 14:10 | Mon 22 (date/time)
-            format_1 = "%a %d";
-            format_2 = "%H:%M";
-            break;
-        case 17: // Mon // 22 Oct (date)
-            format_1 = "%d %b";
-            format_2 = "%a";
-            break;
-    }
-
-    setlocale(LC_ALL, "");
-    strftime(buffer_1, sizeof(buffer_1), format_1, t);
-    if (format_2 == NULL) {
-        buffer_2[0] = 0;
-    } else {
-        strftime(buffer_2, sizeof(buffer_2), format_2, t);
-    }
-    // remove leading zeros
-    if (config_date_format != 7) {
-        remove_leading_zero(buffer_1, sizeof(buffer_1));
-        remove_leading_zero(buffer_2, sizeof(buffer_1));
-    }
+    // format date strings (only if the fields they show changed)
+    format_date(t);
+    char *date_1 = date_buffer_1;
+    char *date_2 = date_buffer_2;
 
-    bool big = buffer_2[0] == 0;
+    bool big = date_2[0] == 0;
     int date_font_size = 18;
     if (big) {
         if (config_date_format == 1 || config_date_format == 5) {
@@ -680,8 +1353,10 @@ void background_update_proc(Layer *layer, GContext *ctx) {
 #endif
 
     // determine size
-    const int d_w1 = string_width(&fctx, buffer_2, date_font, date_font_size);
-    const int d_w2 = string_width(&fctx, buffer_1, date_font, date_font_size);
+    PROFILE_STAGE("measure");
+    const int d_w1 = string_width(fctx, date_2, date_font, date_font_size);
+    const int d_w2 = string_width(fctx, date_1, date_font, date_font_size);
+    PROFILE_STAGE("date");
 
     // determine where we can draw the date without overlap
     const int d_offset = SCALED_EMERY(PBL_IF_ROUND_ELSE(20, 15)) + SCALED_EMERY(big ? -PBL_IF_ROUND_ELSE(12, 10) : 0);
@@ -690,43 +1365,47 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     bool found = false;
     uint16_t i;
     GPoint d_center;
-    GRect date_pos;
-    GRect day_pos;
     const int border = 2;
-    // loop through all points and use the first one that doesn't overlap with the watch hands
-    for (i = 0; i < 1 + (ARRAY_LENGTH(d_points) - 1) * 2; i++) {
-        d_center = d_points[(i + 1) / 2];
-        if (i % 2 == 0) {
-            d_center.x = -d_center.x;
-        }
+    // the search only runs if the hands, the bounds or the text changed
+    const PlacementKey d_key = placement_key(t->tm_min, hour_tick, d_w1, d_w2, d_height);
+    int16_t d_index = -1;
+    if (!placement_lookup(&placement_date, &d_key, &d_index)) {
+        // loop through all points and use the first one that doesn't overlap with the watch hands
+        for (i = 0; i < 1 + (ARRAY_LENGTH(d_points) - 1) * 2; i++) {
+            d_center = placement_candidate(d_points, i);
 #ifdef PBL_ROUND
-        d_center.x = d_center.x * 7 / 6;
-        //d_center.y = d_center.y * 7 / 6;
-#endif
-        date_pos = GRect(d_center.x, d_y_start + d_center.y + d_offset, width, d_height);
-        day_pos = GRect(d_center.x, d_y_start + d_center.y, width, d_height);
-
-        if (!(line2_rect_intersect(center, hour_hand, center, minute_hand,
-                                   GPoint(width / 2 + d_center.x - d_w1 / 2 - border,
-                                          d_y_start + d_center.y),
-                                   GPoint(width / 2 + d_center.x + d_w1 / 2 + border,
-                                          d_y_start + d_center.y + d_height + 2 * border)) ||
-              line2_rect_intersect(center, hour_hand, center, minute_hand,
-                                   GPoint(width / 2 + d_center.x - d_w2 / 2 - border,
-                                          d_y_start + d_center.y + d_offset),
-                                   GPoint(width / 2 + d_center.x + d_w2 / 2 + border,
-                                          d_y_start + d_center.y + d_height + d_offset + 2 * border)))) {
-            found = true;
-            break;
+            d_center.x = d_center.x * 7 / 6;
+            //d_center.y = d_center.y * 7 / 6;
+#endif
+            if (!(line2_rect_intersect(center, hour_hand, center, minute_hand,
+                                       GPoint(width / 2 + d_center.x - d_w1 / 2 - border,
+                                              d_y_start + d_center.y),
+                                       GPoint(width / 2 + d_center.x + d_w1 / 2 + border,
+                                              d_y_start + d_center.y + d_height + 2 * border)) ||
+                  line2_rect_intersect(center, hour_hand, center, minute_hand,
+                                       GPoint(width / 2 + d_center.x - d_w2 / 2 - border,
+                                              d_y_start + d_center.y + d_offset),
+                                       GPoint(width / 2 + d_center.x + d_w2 / 2 + border,
+                                              d_y_start + d_center.y + d_height + d_offset + 2 * border)))) {
+                d_index = i;
+                break;
+            }
         }
+        placement_store(&placement_date, &d_key, d_index);
     }
 
-    // this should not happen, but if it does, then use the default position
-    if (!found) {
+    found = d_index >= 0;
+    if (found) {
+        d_center = placement_candidate(d_points, d_index);
+#ifdef PBL_ROUND
+        d_center.x = d_center.x * 7 / 6;
+#endif
+    } else {
+        // this should not happen, but if it does, then use the default position
         d_center = d_points[0];
-        day_pos = GRect(d_center.x, d_y_start + d_center.y, width, d_height);
-        date_pos = GRect(d_center.x, d_y_start + d_center.y + d_offset, width, d_height);
     }
+    GRect day_pos = GRect(d_center.x, d_y_start + d_center.y, width, d_height);
+    GRect date_pos = GRect(d_center.x, d_y_start + d_center.y + d_offset, width, d_height);
 
 //    // show bounding box
 //    if (!big) {
@@ -741,25 +1420,30 @@ void background_update_proc(Layer *layer, GContext *ctx) {
 //                                  d_height+ 2* border));
 
     // actuallyl draw the date text
+    CachedString date_strings[] = {
+            {date_2, day_pos.origin, date_font, COLOR(config_color_day_of_week), date_font_size, true},
+            {date_1, date_pos.origin, date_font, COLOR(config_color_date), date_font_size, true},
+    };
+    // the first line is only there for two-line formats
+    uint8_t first_line = 1;
 #ifndef DEBUG_NO_DATE
     if (!big) {
-        draw_string(&fctx, buffer_2, day_pos.origin, date_font, COLOR(config_color_day_of_week), date_font_size, true);
+        first_line = 0;
     }
 #endif
-    draw_string(&fctx, buffer_1, date_pos.origin, date_font, COLOR(config_color_date), date_font_size, true);
+    draw_cached_strings(fctx, ctx, TEXT_CACHE_DATE, &date_strings[first_line], 2 - first_line);
 
     // weather information
-    bool weather_is_on = config_weather_refresh > 0;
-    bool weather_is_available = weather.timestamp > 0;
-    bool weather_is_outdated = (time(NULL) - weather.timestamp) > (config_weather_expiration * 60);
-    bool show_weather = weather_is_on && weather_is_available && !weather_is_outdated;
-    if (show_weather ||
+    PROFILE_STAGE("weather");
+    bool show_weather = weather_is_visible();
+    // without weather, the first frame is drawn before the weather font is loaded (see OBSIDIAN_DEFERRED_INIT)
+    if (font_weather != NULL && (show_weather ||
         #ifdef PBL_ROUND
         (!bluetooth && config_bluetooth_logo)
         #else
         false
 #endif
-            ) {
+            )) {
         int temp = weather.temperature;
         if (weather.failed) {
 #ifdef PBL_ROUND
@@ -783,7 +1467,7 @@ void background_update_proc(Layer *layer, GContext *ctx) {
                 buffer_2[0] = 0;
             } else if (!bluetooth && config_bluetooth_logo) {
                 snprintf(buffer_1, 10, "z%c", weather.icon);
-                snprintf(buffer_1, 10, "%d°", temp);
+                snprintf(buffer_2, 10, "%d°", temp);
             } else {
 #endif
             snprintf(buffer_1, 10, "%c", weather.icon);
@@ -800,38 +1484,49 @@ void background_update_proc(Layer *layer, GContext *ctx) {
         int w_font_size2 = SCALED_EMERY(PBL_IF_ROUND_ELSE(18 * 4 / 3, 18));
         int w_font_size1 = w_font_size2 + w_font_size2 * 10 / 34;
         const int w_height = w_font_size2;
-        const int w_w1 = string_width(&fctx, buffer_1, font_weather, w_font_size1);
-        const int w_w2 = string_width(&fctx, buffer_2, font_main, w_font_size2);
+        PROFILE_STAGE("measure");
+        const int w_w1 = string_width(fctx, buffer_1, font_weather, w_font_size1);
+        const int w_w2 = string_width(fctx, buffer_2, font_main, w_font_size2);
+        PROFILE_STAGE("weather");
         const int w_w = w_w1 + w_w2 + 1;
 
         GSize weather_size = GSize(w_w, w_height);
-        // loop through all points and use the first one that doesn't overlap with the watch hands
-        for (i = 0; i < 1 + (ARRAY_LENGTH(w_points) - 1) * 2; i++) {
-//            i = debug_iter % ARRAY_LENGTH(w_points);
-//            i = i*2+1;
-            w_center = w_points[(i + 1) / 2];
-            if (i % 2 == 0) {
-                w_center.x = -w_center.x;
-            }
-//            break;
-            if (!line2_rect_intersect(center, hour_hand, center, minute_hand,
-                                      GPoint(w_x + w_center.x - weather_size.w / 2 - w_border,
-                                             w_y + w_center.y),
-                                      GPoint(w_x + w_center.x + weather_size.w / 2 + w_border,
-                                             w_y + w_center.y + w_height + 2 * w_border))) {
-                found = true;
-                break;
+        // the search only runs if the hands, the bounds or the text changed (the default position is only used if
+        // the date could not be placed either)
+        const PlacementKey w_key = placement_key(t->tm_min, hour_tick, w_w, w_height, found);
+        int16_t w_index = -1;
+        if (!placement_lookup(&placement_weather, &w_key, &w_index)) {
+            // loop through all points and use the first one that doesn't overlap with the watch hands
+            for (i = 0; i < 1 + (ARRAY_LENGTH(w_points) - 1) * 2; i++) {
+//                i = debug_iter % ARRAY_LENGTH(w_points);
+//                i = i*2+1;
+                w_index = i;
+                w_center = placement_candidate(w_points, i);
+//                break;
+                if (!line2_rect_intersect(center, hour_hand, center, minute_hand,
+                                          GPoint(w_x + w_center.x - weather_size.w / 2 - w_border,
+                                                 w_y + w_center.y),
+                                          GPoint(w_x + w_center.x + weather_size.w / 2 + w_border,
+                                                 w_y + w_center.y + w_height + 2 * w_border))) {
+                    found = true;
+                    break;
+                }
             }
-        }
 
-        // this should not happen, but if it does, then use the default position
-        if (!found) {
-            w_center = w_points[0];
+            // this should not happen, but if it does, then use the default position
+            if (!found) {
+                w_index = -1;
+            }
+            placement_store(&placement_weather, &w_key, w_index);
         }
+        w_center = placement_candidate(w_points, w_index);
         GPoint pos1 = GPoint(w_center.x - w_w / 2, w_y + w_center.y + 2);
         GPoint pos2 = GPoint(w_center.x - w_w / 2 + w_w1 + 1, w_y + w_center.y);
-        draw_string(&fctx, buffer_1, pos1, font_weather, COLOR(config_color_weather), w_font_size1, false);
-        draw_string(&fctx, buffer_2, pos2, font_main, COLOR(config_color_weather), w_font_size2, false);
+        CachedString weather_strings[] = {
+                {buffer_1, pos1, font_weather, COLOR(config_color_weather), w_font_size1, false},
+                {buffer_2, pos2, font_main, COLOR(config_color_weather), w_font_size2, false},
+        };
+        draw_cached_strings(fctx, ctx, TEXT_CACHE_WEATHER, weather_strings, 2);
 
 //        // show bounding box
 //        graphics_draw_rect(ctx, GRect(w_x + w_center.x - weather_size.w / 2 - w_border,
@@ -843,6 +1538,7 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     snprintf(buffer_1, 5, "21");
 
     // bluetooth status
+    PROFILE_STAGE("bluetooth");
     if (!bluetooth && config_bluetooth_logo) {
 #ifndef PBL_ROUND
         draw_bluetooth_logo(ctx, GPoint(9, 9));
@@ -850,16 +1546,17 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     }
 
     // minute hand
+    PROFILE_STAGE("hands");
     graphics_context_set_stroke_color(ctx, COLOR(config_color_minute_hand));
     graphics_draw_line_with_width(ctx, minute_hand, center, 4);
     graphics_context_set_stroke_color(ctx, COLOR(config_color_inner_minute_hand));
-    graphics_draw_line_with_width(ctx, get_radial_point(radius - PBL_IF_ROUND_ELSE(20, 12), minute_angle), center, 1);
+    graphics_draw_line_with_width(ctx, geometry_point(geometry->minute_hand[t->tm_min][1]), center, 1);
 
     // hour hand
     graphics_context_set_stroke_color(ctx, COLOR(config_color_hour_hand));
     graphics_draw_line_with_width(ctx, hour_hand, center, 4);
     graphics_context_set_stroke_color(ctx, COLOR(config_color_inner_hour_hand));
-    graphics_draw_line_with_width(ctx, get_radial_point(radius * 55 / 100 - 2, hour_angle), center, 1);
+    graphics_draw_line_with_width(ctx, geometry_point(geometry->hour_hand[hour_tick][1]), center, 1);
 
     // dot in the middle
     graphics_context_set_fill_color(ctx, COLOR(config_color_minute_hand));
@@ -868,10 +1565,9 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     graphics_fill_circle(ctx, center, 2);
 
     // battery status
+    PROFILE_STAGE("battery");
     if (!is_obstructed()) {
-        if (config_battery_logo == 1 ||
-            (config_battery_logo == 2 && battery_state.charge_percent <= 30 && !battery_state.is_charging &&
-             !battery_state.is_plugged)) {
+        if (config_battery_logo == 1 || (config_battery_logo == 2 && battery_tier != 0)) {
             GRect battery = PBL_IF_ROUND_ELSE(GRect((width
                                                       -14)/2, 21, 14, 8), GRect(width-19, 3, 14, 8));
             if (config_square) {
@@ -884,28 +1580,27 @@ void background_update_proc(Layer *layer, GContext *ctx) {
             const int b_x = width / 2;
             const int b_y = 25;
             const int b_border = 3;
-            // loop through all points and use the first one that doesn't overlap with the watch hands
-            for (i = 0; i < 1 + (ARRAY_LENGTH(b_points) - 1) * 2; i++) {
-                b_center = b_points[(i + 1) / 2];
-                if (i % 2 == 0) {
-                    b_center.x = -b_center.x;
-                }
-                if (!line2_rect_intersect(center, hour_hand, center, minute_hand,
-                                          GPoint(b_x + b_center.x - battery.size.w/2 - b_border, b_y + b_center.y - b_border),
-                                          GPoint(b_x + b_center.x + battery.size.w/2 + b_border, b_y + b_center.y + battery.size.h + b_border))) {
-                    break;
+            // the search only runs if the hands or the bounds changed
+            const PlacementKey b_key = placement_key(t->tm_min, hour_tick, battery.size.w, battery.size.h, 0);
+            int16_t b_index = 0;
+            if (!placement_lookup(&placement_battery, &b_key, &b_index)) {
+                // loop through all points and use the first one that doesn't overlap with the watch hands
+                for (i = 0; i < 1 + (ARRAY_LENGTH(b_points) - 1) * 2; i++) {
+                    b_index = i;
+                    b_center = placement_candidate(b_points, i);
+                    if (!line2_rect_intersect(center, hour_hand, center, minute_hand,
+                                              GPoint(b_x + b_center.x - battery.size.w/2 - b_border, b_y + b_center.y - b_border),
+                                              GPoint(b_x + b_center.x + battery.size.w/2 + b_border, b_y + b_center.y + battery.size.h + b_border))) {
+                        break;
+                    }
                 }
+                placement_store(&placement_battery, &b_key, b_index);
             }
+            b_center = placement_candidate(b_points, b_index);
             battery = GRect(b_x + b_center.x - battery.size.w/2, b_y + b_center.y, battery.size.w, battery.size.h);
 #endif
-            uint8_t battery_color = config_color_battery_logo;
-            if (battery_state.charge_percent <= 10 && !battery_state.is_charging && !battery_state.is_plugged) {
-                battery_color = config_color_battery_10;
-            } else if (battery_state.charge_percent <= 20 && !battery_state.is_charging && !battery_state.is_plugged) {
-                battery_color = config_color_battery_20;
-            } else if (battery_state.charge_percent <= 30 && !battery_state.is_charging && !battery_state.is_plugged) {
-                battery_color = config_color_battery_30;
-            }
+            const uint8_t battery_color = battery_tier_color(config_color_battery_logo, config_color_battery_30,
+                                                             config_color_battery_20, config_color_battery_10);
             graphics_context_set_stroke_color(ctx, COLOR(battery_color));
             graphics_context_set_fill_color(ctx, COLOR(battery_color));
             graphics_draw_rect(ctx, battery);
@@ -918,9 +1613,188 @@ void background_update_proc(Layer *layer, GContext *ctx) {
     }
 
     // draw the bluetooth popup
-    bluetooth_popup(&fctx, ctx, bluetooth);
+    PROFILE_STAGE("popup");
+    bluetooth_popup(fctx, ctx, bluetooth);
+}
 
-    // end fctx
-    fctx_deinit_context(&fctx);
+/**
+ * Bounding box of the seconds pointer at target, clipped to the frame buffer.
+ */
+static GRect seconds_pointer_box(GBitmap *frame_buffer, GPoint target) {
+    const GRect screen = gbitmap_get_bounds(frame_buffer);
+    int16_t x0 = target.x - SECONDS_POINTER_EXTENT, x1 = target.x + SECONDS_POINTER_EXTENT;
+    int16_t y0 = target.y - SECONDS_POINTER_EXTENT, y1 = target.y + SECONDS_POINTER_EXTENT;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > screen.size.w - 1) x1 = screen.size.w - 1;
+    if (y1 > screen.size.h - 1) y1 = screen.size.h - 1;
+    return GRect(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
 }
 
+/**
+ * Copy a box of the frame buffer into the save-under buffer, or back into the frame buffer if restore is set.  On
+ * black and white watches, the whole bytes covering the box are copied.
+ */
+static void copy_seconds_save_under(GBitmap *frame_buffer, GRect box, bool restore) {
+    for (int16_t y = box.origin.y; y < box.origin.y + box.size.h; y++) {
+#ifdef PBL_COLOR
+        // only copy the visible part of the row (relevant on round displays)
+        GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, y);
+        const int16_t x0 = box.origin.x > info.min_x ? box.origin.x : info.min_x;
+        const int16_t x1 = box.origin.x + box.size.w - 1 < info.max_x ? box.origin.x + box.size.w - 1 : info.max_x;
+        if (x1 < x0) continue;
+        uint8_t *screen_row = &info.data[x0];
+        uint8_t *saved_row = &seconds_save_under[(y - box.origin.y) * SECONDS_BOX_SIZE + (x0 - box.origin.x)];
+        const size_t length = x1 - x0 + 1;
+#else
+        const uint16_t screen_bytes_per_row = gbitmap_get_bytes_per_row(frame_buffer);
+        const int16_t x0 = box.origin.x / 8;
+        const int16_t x1 = (box.origin.x + box.size.w - 1) / 8;
+        uint8_t *screen_row = &gbitmap_get_data(frame_buffer)[y * screen_bytes_per_row + x0];
+        uint8_t *saved_row = &seconds_save_under[(y - box.origin.y) * SECONDS_BOX_SIZE];
+        const size_t length = x1 - x0 + 1;
+#endif
+        if (restore) {
+            memcpy(screen_row, saved_row, length);
+        } else {
+            memcpy(saved_row, screen_row, length);
+        }
+    }
+}
+
+/**
+ * Update procedure for everything that moves.
+ *
+ * With OBSIDIAN_INCREMENTAL_SECONDS, the seconds pointer is drawn last and the pixels below it are kept.  If only
+ * the seconds changed, the previous frame is still on screen, and moving the pointer just means putting back the
+ * pixels below the old pointer and drawing the new one.
+ */
+void hands_update_proc(Layer *layer, GContext *ctx) {
+#ifdef OBSIDIAN_INCREMENTAL_SECONDS
+    const bool seconds_only = seconds_only_frame;
+    seconds_only_frame = false;
+    seconds_box_valid = false;
+    if (config_seconds != 0) {
+        struct tm *t = current_time();
+        const int minute = t->tm_hour * 60 + t->tm_min;
+        const int second = seconds_position(t);
+        if (!seconds_only) {
+            draw_hands(layer, ctx, false);
+        }
+
+        PROFILE_STAGE("seconds");
+        update_bounds();
+        const GPoint target = geometry_point(geometry->minute_ticks[second][0]);
+        GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+        if (frame_buffer) {
+            if (seconds_only) {
+                copy_seconds_save_under(frame_buffer, seconds_box, true);
+            }
+            seconds_box = seconds_pointer_box(frame_buffer, target);
+            copy_seconds_save_under(frame_buffer, seconds_box, false);
+            seconds_box_valid = true;
+            seconds_box_minute = minute;
+            graphics_release_frame_buffer(ctx, frame_buffer);
+        }
+        draw_pointer(ctx, target, second * TRIG_MAX_ANGLE / 60, COLOR(config_color_seconds));
+        return;
+    }
+#endif
+    draw_hands(layer, ctx, true);
+}
+
+/**
+ * The inputs every component of the face is drawn from.
+ */
+static const struct {
+    uint16_t component;
+    uint16_t inputs;
+} component_inputs[] = {
+        // the relevant minute ticks and the battery color are part of the background
+        {COMPONENT_BACKGROUND, INPUT_MINUTE | INPUT_BATTERY | INPUT_CONFIG | INPUT_SCREEN},
+        {COMPONENT_SECONDS,    INPUT_SECOND | INPUT_CONFIG | INPUT_SCREEN},
+        {COMPONENT_MINUTE_HAND, INPUT_MINUTE | INPUT_CONFIG | INPUT_SCREEN},
+        {COMPONENT_HOUR_HAND,  INPUT_HOUR | INPUT_CONFIG | INPUT_SCREEN},
+        // the date and weather are placed so that they do not overlap with the hands
+        {COMPONENT_DATE,       INPUT_DAY | INPUT_MINUTE | INPUT_HOUR | INPUT_CONFIG | INPUT_SCREEN},
+        {COMPONENT_WEATHER,    INPUT_WEATHER | INPUT_BLUETOOTH | INPUT_MINUTE | INPUT_HOUR | INPUT_CONFIG | INPUT_SCREEN},
+        {COMPONENT_BATTERY,
+         INPUT_BATTERY | PBL_IF_ROUND_ELSE(INPUT_MINUTE | INPUT_HOUR, 0) | INPUT_CONFIG | INPUT_SCREEN},
+        {COMPONENT_BLUETOOTH,  INPUT_BLUETOOTH | INPUT_CONFIG | INPUT_SCREEN},
+        {COMPONENT_POPUP,      INPUT_POPUP | INPUT_BLUETOOTH | INPUT_CONFIG | INPUT_SCREEN},
+};
+
+/** The time the face was last marked dirty for (see mark_time_changed). */
+static int last_second = -1;
+static int last_minute = -1;
+static int last_hour_tick = -1;
+static int last_day = -1;
+
+/**
+ * Mark the components that depend on any of the given inputs (INPUT_* flags) dirty, and request a redraw if there
+ * are any.  If only the seconds pointer is dirty, the next frame just moves the pointer (see hands_update_proc).
+ */
+void mark_inputs_changed(uint16_t inputs) {
+    uint16_t components = 0;
+    for (uint8_t i = 0; i < ARRAY_LENGTH(component_inputs); i++) {
+        if (component_inputs[i].inputs & inputs) {
+            components |= component_inputs[i].component;
+        }
+    }
+    if (components == 0) return;
+    dirty_components |= components;
+    layer_mark_dirty(layer_hands);
+}
+
+/**
+ * Work out which parts of the time shown on the face changed since the last call, and mark them changed.  Ticks
+ * that do not move anything (e.g., seconds between two positions of the seconds pointer) do not cause a redraw.
+ */
+void mark_time_changed() {
+    struct tm *t = current_time();
+    const int second = config_seconds != 0 ? seconds_position(t) : -1;
+    const int minute = t->tm_hour * 60 + t->tm_min;
+    const int hour_tick = ((t->tm_hour % 12) * 6) + (t->tm_min / 10);
+    const int day = t->tm_year * 366 + t->tm_yday;
+
+    uint16_t inputs = 0;
+    if (second != last_second) inputs |= INPUT_SECOND;
+    if (minute != last_minute) inputs |= INPUT_MINUTE;
+    if (hour_tick != last_hour_tick) inputs |= INPUT_HOUR;
+    if (day != last_day) inputs |= INPUT_DAY;
+    last_second = second;
+    last_minute = minute;
+    last_hour_tick = hour_tick;
+    last_day = day;
+    mark_inputs_changed(inputs);
+}
+
+/**
+ * Allocate everything the update procedures need, so that drawing a frame does not touch the heap.  Called once the
+ * fonts are loaded.
+ */
+void drawing_create() {
+    set_battery_state(battery_state_service_peek());
+    advance_tables_create();
+    text_cache_create();
+    background_cache_create();
+    pointer_path = gpath_create(&pointer_path_info);
+    render_fctx_valid = false;
+}
+
+/**
+ * Free everything allocated by drawing_create (and the fctx context of the last frame).
+ */
+void drawing_destroy() {
+    advance_tables_destroy();
+    text_cache_destroy();
+    background_cache_destroy();
+    if (pointer_path) {
+        gpath_destroy(pointer_path);
+        pointer_path = NULL;
+    }
+    if (render_fctx_valid) {
+        fctx_deinit_context(&render_fctx);
+        render_fctx_valid = false;
+    }
+}
@@ -17,9 +17,47 @@
 
 #include "obsidian.h"
 
+/** Inputs the face is drawn from; events report the ones that changed with mark_inputs_changed. */
+#define INPUT_SECOND (1 << 0)
+#define INPUT_MINUTE (1 << 1)
+// the hour hand moves every 10 minutes
+#define INPUT_HOUR (1 << 2)
+#define INPUT_DAY (1 << 3)
+#define INPUT_BLUETOOTH (1 << 4)
+#define INPUT_POPUP (1 << 5)
+#define INPUT_WEATHER (1 << 6)
+#define INPUT_BATTERY (1 << 7)
+#define INPUT_CONFIG (1 << 8)
+// the window appeared, so nothing on screen can be relied on
+#define INPUT_SCREEN (1 << 9)
+
+/** The components of the face, and which inputs they depend on (see component_inputs in drawing.c). */
+#define COMPONENT_BACKGROUND (1 << 0)
+#define COMPONENT_SECONDS (1 << 1)
+#define COMPONENT_MINUTE_HAND (1 << 2)
+#define COMPONENT_HOUR_HAND (1 << 3)
+#define COMPONENT_DATE (1 << 4)
+#define COMPONENT_WEATHER (1 << 5)
+#define COMPONENT_BATTERY (1 << 6)
+#define COMPONENT_BLUETOOTH (1 << 7)
+#define COMPONENT_POPUP (1 << 8)
+#define COMPONENT_ALL ((1 << 9) - 1)
+
 void graphics_draw_line_with_width(GContext *ctx, GPoint p0, GPoint p1, uint8_t width);
 void draw_bluetooth_logo(GContext *ctx, GPoint origin);
 void bluetooth_popup(FContext* fctx, GContext *ctx, bool connected);
 void background_update_proc(Layer *layer, GContext *ctx);
+void hands_update_proc(Layer *layer, GContext *ctx);
+void mark_inputs_changed(uint16_t inputs);
+void mark_time_changed();
+bool set_battery_state(BatteryChargeState state);
+bool weather_is_visible();
+bool weather_font_needed();
+bool date_format_shows_names(uint8_t date_format);
+void drawing_create();
+void drawing_destroy();
+void advance_tables_create();
+void advance_tables_destroy();
+void background_cache_invalidate();
 
 #endif //OBSIDIAN_DRAWING_H
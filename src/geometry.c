@@ -14,6 +14,40 @@
 
 #include "geometry.h"
 
+// the geometry of the whole screen (geometry_circle, and geometry_square on rectangular watches), generated by
+// host/geometry_tables.c; the generator itself computes them
+#if defined(OBSIDIAN_GEOMETRY_GENERATOR)
+static const Geometry geometry_circle;
+#ifndef PBL_ROUND
+static const Geometry geometry_square;
+#endif
+#elif defined(PBL_PLATFORM_EMERY)
+#include "geometry_tables_emery.h"
+#elif defined(PBL_ROUND)
+#include "geometry_tables_round.h"
+#else
+#include "geometry_tables_rect.h"
+#endif
+
+#if !defined(OBSIDIAN_GEOMETRY_GENERATOR) && GEOMETRY_TABLES_LONG_TICKS != defined(OBSIDIAN_LONG_TICKS)
+#error "the geometry tables are out of date (OBSIDIAN_LONG_TICKS), regenerate them with the geometry_tables target"
+#endif
+
+/** End points of ticks and hands, see update_geometry. */
+const Geometry *geometry = &geometry_circle;
+
+/** The geometry of bounds without a table (e.g., the square with a quick view), computed when the bounds change. */
+static Geometry geometry_computed;
+
+/** The bounds and shape the geometry was picked for. */
+static GRect geometry_bounds;
+static int geometry_bounds_square = -1;
+
+/** The angle of the top right corner, for the current width and height. */
+static int16_t topright_width;
+static int16_t topright_height;
+static int32_t topright_angle;
+
 /**
  * Returns a point on the line from the center away at an angle specified by tick/maxtick, at a specified distance
  */
@@ -29,7 +63,11 @@ GPoint get_radial_point(const int16_t distance_from_center, const int32_t angle)
  * Returns a point on the line from the center away at a given angel, at an offset from the border.
  */
 GPoint get_radial_border_point(const int16_t distance_from_border, const int32_t angle) {
-    const int32_t topright_angle = atan2_lookup(width, height);
+    if (topright_width != width || topright_height != height) {
+        topright_width = width;
+        topright_height = height;
+        topright_angle = atan2_lookup(width, height);
+    }
     bool top = angle > (TRIG_MAX_ANGLE - topright_angle) || angle <= topright_angle;
 //    bool right = angle > topright_angle && angle <= TRIG_MAX_ANGLE/2 - topright_angle;
     bool bottom = angle > TRIG_MAX_ANGLE/2 - topright_angle && angle <= TRIG_MAX_ANGLE/2 + topright_angle;
@@ -52,50 +90,189 @@ GPoint get_radial_border_point(const int16_t distance_from_border, const int32_t
     return result;
 }
 
+/** Outcode bits of a point (Cohen-Sutherland): on which sides of the rectangle it lies outside. */
+#define OUTCODE_LEFT 1
+#define OUTCODE_RIGHT 2
+#define OUTCODE_TOP 4
+#define OUTCODE_BOTTOM 8
+
+/** A rectangle with inclusive edges, normalized so that left <= right and top <= bottom. */
+typedef struct {
+    int16_t left;
+    int16_t top;
+    int16_t right;
+    int16_t bottom;
+} ClipRect;
+
+static inline ClipRect clip_rect(const GPoint rect0, const GPoint rect1) {
+    return (ClipRect) {
+            .left = rect0.x < rect1.x ? rect0.x : rect1.x,
+            .top = rect0.y < rect1.y ? rect0.y : rect1.y,
+            .right = rect0.x < rect1.x ? rect1.x : rect0.x,
+            .bottom = rect0.y < rect1.y ? rect1.y : rect0.y,
+    };
+}
+
+static inline uint8_t outcode(const GPoint p, const ClipRect *rect) {
+    uint8_t code = 0;
+    if (p.x < rect->left) {
+        code |= OUTCODE_LEFT;
+    } else if (p.x > rect->right) {
+        code |= OUTCODE_RIGHT;
+    }
+    if (p.y < rect->top) {
+        code |= OUTCODE_TOP;
+    } else if (p.y > rect->bottom) {
+        code |= OUTCODE_BOTTOM;
+    }
+    return code;
+}
+
+/**
+ * Does the segment p0->p1 with the outcodes code0 and code1 touch the rectangle?  Segments with an end point inside
+ * are accepted, and segments with both end points beyond the same edge are rejected, without any arithmetic.  The
+ * remaining segments reach across the rectangle in both directions, and touch it unless all four corners are strictly
+ * on one side of the line (the cross products need 32 bits: on emery, they exceed the range of int16_t).
+ */
+static bool segment_rect_touch(const GPoint p0, const uint8_t code0, const GPoint p1, const uint8_t code1,
+                               const ClipRect *rect) {
+    if (code0 & code1) return false;
+    if (code0 == 0 || code1 == 0) return true;
+    const int32_t dx = p1.x - p0.x;
+    const int32_t dy = p1.y - p0.y;
+    const int32_t left = dy * (rect->left - p0.x);
+    const int32_t right = dy * (rect->right - p0.x);
+    const int32_t top = dx * (rect->top - p0.y);
+    const int32_t bottom = dx * (rect->bottom - p0.y);
+    // the side of each corner is the sign of dx * (y - p0.y) - dy * (x - p0.x)
+    const int32_t top_left = top - left;
+    const int32_t top_right = top - right;
+    const int32_t bottom_left = bottom - left;
+    const int32_t bottom_right = bottom - right;
+    const bool all_above = top_left > 0 && top_right > 0 && bottom_left > 0 && bottom_right > 0;
+    const bool all_below = top_left < 0 && top_right < 0 && bottom_left < 0 && bottom_right < 0;
+    return !all_above && !all_below;
+}
+
+/**
+ * Returns true if the line segment touches the rectangle with the corners rect0 and rect1 (edges included), also if
+ * it lies completely inside.
+ */
+bool line_rect_intersect(GPoint line0, GPoint line1, GPoint rect0, GPoint rect1) {
+    const ClipRect rect = clip_rect(rect0, rect1);
+    return segment_rect_touch(line0, outcode(line0, &rect), line1, outcode(line1, &rect), &rect);
+}
+
+/**
+ * Returns true if either of two line segments (the hands) touches the rectangle.  The outcodes of all end points are
+ * computed first, so a rectangle that is clear of both hands (or that contains an end point) is usually decided
+ * without a multiplication.
+ */
+bool line2_rect_intersect(GPoint lineA0, GPoint lineA1, GPoint lineB0, GPoint lineB1, GPoint rect0, GPoint rect1) {
+    const ClipRect rect = clip_rect(rect0, rect1);
+    const uint8_t codeA0 = outcode(lineA0, &rect);
+    const uint8_t codeA1 = outcode(lineA1, &rect);
+    const uint8_t codeB0 = outcode(lineB0, &rect);
+    const uint8_t codeB1 = outcode(lineB1, &rect);
+    // trivial reject of both, or trivial accept of either
+    const bool rejectA = (codeA0 & codeA1) != 0;
+    const bool rejectB = (codeB0 & codeB1) != 0;
+    if (rejectA && rejectB) return false;
+    if ((!rejectA && (codeA0 == 0 || codeA1 == 0)) || (!rejectB && (codeB0 == 0 || codeB1 == 0))) return true;
+    return (!rejectA && segment_rect_touch(lineA0, codeA0, lineA1, codeA1, &rect)) ||
+           (!rejectB && segment_rect_touch(lineB0, codeB0, lineB1, codeB1, &rect));
+}
+
+/**
+ * The offset of a point from the center.
+ */
+static GeometryOffset offset(const GPoint point) {
+    return (GeometryOffset) {.x = (int8_t) (point.x - center.x), .y = (int8_t) (point.y - center.y)};
+}
+
 /**
- * Do the line segments a0->a1 and b0->b1 intersect?
- * Loosely based on http://stackoverflow.com/questions/4977491/determining-if-two-line-segments-intersect/4977569#4977569
+ * Compute the end points of all ticks and hands for the current center, width, height and config_square.
  */
-bool intersect(const GPoint a0, const GPoint a1, const GPoint b0, const GPoint b1) {
-    GPoint va = GPoint(a1.x - a0.x, a1.y - a0.y);
-    GPoint vb = GPoint(b1.x - b0.x, b1.y - b0.y);
-
-    // test for parallel line segments
-    int16_t det = vb.x * va.y - va.x * vb.y;
-    if (det == 0) {
-        if ((b0.x - a0.x) * va.y == (b0.y - a0.y) * va.x) {
-            // the two lines are parallel, and might overlap (if the segments were extended infinitely, they would be the same line)
-            return (0 <= b0.x - a0.x && b0.x - a0.x <= va.x) || (0 <= a0.x - b0.x && a0.x - b0.x <= vb.x);
+void compute_geometry(Geometry *result) {
+    const int16_t radius = width / 2;
+    for (int i = 0; i < 12; i++) {
+        const int32_t angle = i * TRIG_MAX_ANGLE / 12;
+        if (!config_square) {
+            int tick_length = PBL_IF_ROUND_ELSE(8, 6);
+#ifdef OBSIDIAN_LONG_TICKS
+            if (i % 3 == 0) {
+                tick_length = PBL_IF_ROUND_ELSE(12, 10);
+            }
+#endif
+            result->hour_ticks[i][0] = offset(get_radial_point(radius + PBL_IF_ROUND_ELSE(3, 0), angle));
+            result->hour_ticks[i][1] = offset(get_radial_point(radius - tick_length, angle));
         } else {
-            // the two lines are parallel, and not overlapping
-            return false;
+            result->hour_ticks[i][0] = offset(get_radial_border_point(0, angle));
+            result->hour_ticks[i][1] = offset(get_radial_border_point((i % 3 == 0) ? 12 : 8, angle));
         }
     }
-
-    int16_t s = ((a0.x - b0.x) * va.y - (a0.y - b0.y) * va.x);
-    int16_t t = -(-(a0.x - b0.x) * vb.y + (a0.y - b0.y) * vb.x);
-
-    if (det < 0) {
-        det = -det;
-        s = -s;
-        t = -t;
+    for (int i = 0; i < 60; i++) {
+        const int32_t angle = i * TRIG_MAX_ANGLE / 60;
+        if (!config_square) {
+            result->minute_ticks[i][0] = offset(get_radial_point(radius + PBL_IF_ROUND_ELSE(3, 0), angle));
+            result->minute_ticks[i][1] = offset(get_radial_point(radius - PBL_IF_ROUND_ELSE(5, 3), angle));
+        } else {
+            result->minute_ticks[i][0] = offset(get_radial_border_point(0, angle));
+            result->minute_ticks[i][1] = offset(get_radial_border_point(4, angle));
+        }
+        result->minute_hand[i][0] = offset(get_radial_point(radius - PBL_IF_ROUND_ELSE(16, 10), angle));
+        result->minute_hand[i][1] = offset(get_radial_point(radius - PBL_IF_ROUND_ELSE(20, 12), angle));
+    }
+    for (int i = 0; i < 12 * 6; i++) {
+        const int32_t angle = i * TRIG_MAX_ANGLE / (12 * 6);
+        result->hour_hand[i][0] = offset(get_radial_point(radius * 55 / 100, angle));
+        result->hour_hand[i][1] = offset(get_radial_point(radius * 55 / 100 - 2, angle));
     }
-    return 0 <= s && s <= det && 0 <= t && t <= det;
 }
 
+#ifdef OBSIDIAN_GEOMETRY_CHECK
+/** Scratch space to compute the geometry a table is checked against. */
+static Geometry geometry_check;
+
 /**
- * Returns true if the line and rectangle intersect.
+ * Log every point of a generated table that differs from the one computed for the current bounds.
  */
-bool line_rect_intersect(GPoint line0, GPoint line1, GPoint rect0, GPoint rect1) {
-    return intersect(line0, line1, rect0, GPoint(rect1.x, rect0.y)) ||
-           intersect(line0, line1, rect0, GPoint(rect0.x, rect1.y)) ||
-           intersect(line0, line1, rect1, GPoint(rect1.x, rect0.y)) ||
-           intersect(line0, line1, rect1, GPoint(rect0.x, rect1.y));
+static void check_geometry(const Geometry *table) {
+    compute_geometry(&geometry_check);
+    const GeometryOffset *expected = (const GeometryOffset *) &geometry_check;
+    const GeometryOffset *actual = (const GeometryOffset *) table;
+    for (size_t i = 0; i < sizeof(Geometry) / sizeof(GeometryOffset); i++) {
+        if (expected[i].x != actual[i].x || expected[i].y != actual[i].y) {
+            APP_LOG(APP_LOG_LEVEL_WARNING, "geometry point %d (square: %d): table %d,%d, computed %d,%d", (int) i,
+                    (int) config_square, actual[i].x, actual[i].y, expected[i].x, expected[i].y);
+        }
+    }
 }
+#endif
 
 /**
- * Returns true if either of two lines intersects with the rectangle.
+ * Pick the geometry for the given bounds (which need to be the bounds that center, width and height were computed
+ * from) and config_square, unless they did not change.  The points are relative to the center, so the generated table
+ * of the circle works for all bounds as wide as the screen (it only depends on the width); the square needs the full
+ * screen.  Other bounds (e.g., the square with a quick view) are computed into geometry_computed.
  */
-bool line2_rect_intersect(GPoint lineA0, GPoint lineA1, GPoint lineB0, GPoint lineB1, GPoint rect0, GPoint rect1) {
-    return line_rect_intersect(lineA0, lineA1, rect0, rect1) || line_rect_intersect(lineB0, lineB1, rect0, rect1);
+void update_geometry(const GRect bounds) {
+    if (geometry_bounds_square == config_square && grect_equal(&geometry_bounds, &bounds)) return;
+    geometry_bounds = bounds;
+    geometry_bounds_square = config_square;
+
+    if (bounds.size.w == PBL_DISPLAY_WIDTH && !config_square) {
+        geometry = &geometry_circle;
+#ifndef PBL_ROUND
+    } else if (bounds.size.w == PBL_DISPLAY_WIDTH && bounds.size.h == PBL_DISPLAY_HEIGHT) {
+        geometry = &geometry_square;
+#endif
+    } else {
+        compute_geometry(&geometry_computed);
+        geometry = &geometry_computed;
+        return;
+    }
+#ifdef OBSIDIAN_GEOMETRY_CHECK
+    check_geometry(geometry);
+#endif
 }
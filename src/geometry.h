@@ -18,9 +18,31 @@
 
 #include "obsidian.h"
 
+/** A point relative to the center of the face (every point of the geometry is less than 128 pixels away). */
+typedef struct {
+    int8_t x;
+    int8_t y;
+} GeometryOffset;
+
+/**
+ * End points of the ticks and hands for all positions, relative to the center.  Index 0 is the outer end; for the
+ * hands, index 1 is the outer end of the inner line.  The seconds pointer is drawn at the outer end of the minute
+ * ticks.
+ */
+typedef struct {
+    GeometryOffset hour_ticks[12][2];
+    GeometryOffset minute_ticks[60][2];
+    GeometryOffset minute_hand[60][2];
+    GeometryOffset hour_hand[12 * 6][2];
+} Geometry;
+
+/** The geometry for the current bounds and shape, see update_geometry. */
+extern const Geometry *geometry;
+
+void update_geometry(const GRect bounds);
+void compute_geometry(Geometry *result);
 GPoint get_radial_point(const int16_t distance_from_center, const int32_t angle);
 GPoint get_radial_border_point(const int16_t distance_from_border, const int32_t angle);
-bool intersect(const GPoint a0, const GPoint a1, const GPoint b0, const GPoint b1);
 bool line_rect_intersect(GPoint line0, GPoint line1, GPoint rect0, GPoint rect1);
 bool line2_rect_intersect(GPoint lineA0, GPoint lineA1, GPoint lineB0, GPoint lineB1, GPoint rect0, GPoint rect1);
 
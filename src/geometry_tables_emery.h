@@ -0,0 +1,128 @@
+// Generated by host/geometry_tables.c for emery (200x228), do not edit.
+// Regenerate with: cmake --build <build-dir> --target geometry_tables
+
+#define GEOMETRY_TABLES_LONG_TICKS 1
+
+static const Geometry geometry_circle = {
+        .hour_ticks = {
+                {{0, -100}, {0, -90}}, {{49, -86}, {46, -81}}, {{86, -50}, {81, -47}}, {{100, 0}, {90, 0}},
+                {{86, 49}, {81, 46}}, {{50, 86}, {47, 81}}, {{0, 100}, {0, 90}}, {{-49, 86}, {-46, 81}},
+                {{-86, 50}, {-81, 47}}, {{-100, 0}, {-90, 0}}, {{-86, -49}, {-81, -46}}, {{-50, -86}, {-47, -81}},
+        },
+        .minute_ticks = {
+                {{0, -100}, {0, -97}}, {{10, -99}, {10, -96}}, {{20, -97}, {20, -94}}, {{30, -95}, {29, -92}},
+                {{40, -91}, {39, -88}}, {{49, -86}, {48, -84}}, {{58, -80}, {57, -78}}, {{66, -74}, {64, -72}},
+                {{74, -66}, {72, -64}}, {{80, -58}, {78, -57}}, {{86, -50}, {84, -48}}, {{91, -40}, {88, -39}},
+                {{95, -30}, {92, -29}}, {{97, -20}, {94, -20}}, {{99, -10}, {96, -10}}, {{100, 0}, {97, 0}},
+                {{99, 10}, {96, 10}}, {{97, 20}, {94, 20}}, {{95, 30}, {92, 29}}, {{91, 40}, {88, 39}},
+                {{86, 49}, {84, 48}}, {{80, 58}, {78, 57}}, {{74, 66}, {72, 64}}, {{66, 74}, {64, 72}},
+                {{58, 80}, {57, 78}}, {{50, 86}, {48, 84}}, {{40, 91}, {39, 88}}, {{30, 95}, {29, 92}},
+                {{20, 97}, {20, 94}}, {{10, 99}, {10, 96}}, {{0, 100}, {0, 97}}, {{-10, 99}, {-10, 96}},
+                {{-20, 97}, {-20, 94}}, {{-30, 95}, {-29, 92}}, {{-40, 91}, {-39, 88}}, {{-49, 86}, {-48, 84}},
+                {{-58, 80}, {-57, 78}}, {{-66, 74}, {-64, 72}}, {{-74, 66}, {-72, 64}}, {{-80, 58}, {-78, 57}},
+                {{-86, 50}, {-84, 48}}, {{-91, 40}, {-88, 39}}, {{-95, 30}, {-92, 29}}, {{-97, 20}, {-94, 20}},
+                {{-99, 10}, {-96, 10}}, {{-100, 0}, {-97, 0}}, {{-99, -10}, {-96, -10}}, {{-97, -20}, {-94, -20}},
+                {{-95, -30}, {-92, -29}}, {{-91, -40}, {-88, -39}}, {{-86, -49}, {-84, -48}}, {{-80, -58}, {-78, -57}},
+                {{-74, -66}, {-72, -64}}, {{-66, -74}, {-64, -72}}, {{-58, -80}, {-57, -78}}, {{-50, -86}, {-48, -84}},
+                {{-40, -91}, {-39, -88}}, {{-30, -95}, {-29, -92}}, {{-20, -97}, {-20, -94}}, {{-10, -99}, {-10, -96}},
+        },
+        .minute_hand = {
+                {{0, -90}, {0, -88}}, {{9, -89}, {9, -87}}, {{18, -88}, {18, -86}}, {{27, -85}, {27, -83}},
+                {{36, -82}, {35, -80}}, {{44, -77}, {43, -76}}, {{52, -72}, {51, -71}}, {{60, -66}, {58, -65}},
+                {{66, -60}, {65, -58}}, {{72, -52}, {71, -51}}, {{77, -45}, {76, -44}}, {{82, -36}, {80, -35}},
+                {{85, -27}, {83, -27}}, {{88, -18}, {86, -18}}, {{89, -9}, {87, -9}}, {{90, 0}, {88, 0}},
+                {{89, 9}, {87, 9}}, {{88, 18}, {86, 18}}, {{85, 27}, {83, 27}}, {{82, 36}, {80, 35}},
+                {{77, 44}, {76, 43}}, {{72, 52}, {71, 51}}, {{66, 60}, {65, 58}}, {{60, 66}, {58, 65}},
+                {{52, 72}, {51, 71}}, {{45, 77}, {44, 76}}, {{36, 82}, {35, 80}}, {{27, 85}, {27, 83}},
+                {{18, 88}, {18, 86}}, {{9, 89}, {9, 87}}, {{0, 90}, {0, 88}}, {{-9, 89}, {-9, 87}},
+                {{-18, 88}, {-18, 86}}, {{-27, 85}, {-27, 83}}, {{-36, 82}, {-35, 80}}, {{-44, 77}, {-43, 76}},
+                {{-52, 72}, {-51, 71}}, {{-60, 66}, {-58, 65}}, {{-66, 60}, {-65, 58}}, {{-72, 52}, {-71, 51}},
+                {{-77, 45}, {-76, 44}}, {{-82, 36}, {-80, 35}}, {{-85, 27}, {-83, 27}}, {{-88, 18}, {-86, 18}},
+                {{-89, 9}, {-87, 9}}, {{-90, 0}, {-88, 0}}, {{-89, -9}, {-87, -9}}, {{-88, -18}, {-86, -18}},
+                {{-85, -27}, {-83, -27}}, {{-82, -36}, {-80, -35}}, {{-77, -44}, {-76, -43}}, {{-72, -52}, {-71, -51}},
+                {{-66, -60}, {-65, -58}}, {{-60, -66}, {-58, -65}}, {{-52, -72}, {-51, -71}}, {{-45, -77}, {-44, -76}},
+                {{-36, -82}, {-35, -80}}, {{-27, -85}, {-27, -83}}, {{-18, -88}, {-18, -86}}, {{-9, -89}, {-9, -87}},
+        },
+        .hour_hand = {
+                {{0, -55}, {0, -53}}, {{4, -54}, {4, -52}}, {{9, -54}, {9, -52}}, {{14, -53}, {13, -51}},
+                {{18, -51}, {18, -49}}, {{23, -49}, {22, -48}}, {{27, -47}, {26, -45}}, {{31, -45}, {30, -43}},
+                {{35, -42}, {34, -40}}, {{38, -38}, {37, -37}}, {{42, -35}, {40, -34}}, {{45, -31}, {43, -30}},
+                {{47, -27}, {45, -26}}, {{49, -23}, {48, -22}}, {{51, -18}, {49, -18}}, {{53, -14}, {51, -13}},
+                {{54, -9}, {52, -9}}, {{54, -4}, {52, -4}}, {{55, 0}, {53, 0}}, {{54, 4}, {52, 4}},
+                {{54, 9}, {52, 9}}, {{53, 14}, {51, 13}}, {{51, 18}, {49, 18}}, {{49, 23}, {48, 22}},
+                {{47, 27}, {45, 26}}, {{45, 31}, {43, 30}}, {{42, 35}, {40, 34}}, {{38, 38}, {37, 37}},
+                {{35, 42}, {34, 40}}, {{31, 45}, {30, 43}}, {{27, 47}, {26, 45}}, {{23, 49}, {22, 48}},
+                {{18, 51}, {18, 49}}, {{14, 53}, {13, 51}}, {{9, 54}, {9, 52}}, {{4, 54}, {4, 52}},
+                {{0, 55}, {0, 53}}, {{-4, 54}, {-4, 52}}, {{-9, 54}, {-9, 52}}, {{-14, 53}, {-13, 51}},
+                {{-18, 51}, {-18, 49}}, {{-23, 49}, {-22, 48}}, {{-27, 47}, {-26, 45}}, {{-31, 45}, {-30, 43}},
+                {{-35, 42}, {-34, 40}}, {{-38, 38}, {-37, 37}}, {{-42, 35}, {-40, 34}}, {{-45, 31}, {-43, 30}},
+                {{-47, 27}, {-45, 26}}, {{-49, 23}, {-48, 22}}, {{-51, 18}, {-49, 18}}, {{-53, 14}, {-51, 13}},
+                {{-54, 9}, {-52, 9}}, {{-54, 4}, {-52, 4}}, {{-55, 0}, {-53, 0}}, {{-54, -4}, {-52, -4}},
+                {{-54, -9}, {-52, -9}}, {{-53, -14}, {-51, -13}}, {{-51, -18}, {-49, -18}}, {{-49, -23}, {-48, -22}},
+                {{-47, -27}, {-45, -26}}, {{-45, -31}, {-43, -30}}, {{-42, -35}, {-40, -34}}, {{-38, -38}, {-37, -37}},
+                {{-35, -42}, {-34, -40}}, {{-31, -45}, {-30, -43}}, {{-27, -47}, {-26, -45}}, {{-23, -49}, {-22, -48}},
+                {{-18, -51}, {-18, -49}}, {{-14, -53}, {-13, -51}}, {{-9, -54}, {-9, -52}}, {{-4, -54}, {-4, -52}},
+        },
+};
+
+static const Geometry geometry_square = {
+        .hour_ticks = {
+                {{0, -114}, {0, -102}}, {{65, -114}, {61, -106}}, {{100, -57}, {92, -53}}, {{100, 0}, {88, 0}},
+                {{100, 57}, {92, 53}}, {{65, 114}, {61, 106}}, {{0, 114}, {0, 102}}, {{-65, 114}, {-61, 106}},
+                {{-100, 57}, {-92, 53}}, {{-100, 0}, {-88, 0}}, {{-100, -57}, {-92, -53}}, {{-65, -114}, {-61, -106}},
+        },
+        .minute_ticks = {
+                {{0, -114}, {0, -110}}, {{11, -114}, {11, -110}}, {{24, -114}, {23, -110}}, {{37, -114}, {35, -110}},
+                {{50, -114}, {48, -110}}, {{65, -114}, {63, -110}}, {{82, -114}, {79, -110}}, {{100, -111}, {96, -106}},
+                {{100, -90}, {96, -86}}, {{100, -72}, {96, -69}}, {{100, -57}, {96, -55}}, {{100, -44}, {96, -42}},
+                {{100, -32}, {96, -31}}, {{100, -21}, {96, -20}}, {{100, -10}, {96, -10}}, {{100, 0}, {96, 0}},
+                {{100, 10}, {96, 10}}, {{100, 21}, {96, 20}}, {{100, 32}, {96, 31}}, {{100, 44}, {96, 42}},
+                {{100, 57}, {96, 55}}, {{100, 72}, {96, 69}}, {{100, 90}, {96, 86}}, {{100, 111}, {96, 106}},
+                {{82, 114}, {79, 110}}, {{65, 114}, {63, 110}}, {{50, 114}, {48, 110}}, {{37, 114}, {35, 110}},
+                {{24, 114}, {23, 110}}, {{11, 114}, {11, 110}}, {{0, 114}, {0, 110}}, {{-11, 114}, {-11, 110}},
+                {{-24, 114}, {-23, 110}}, {{-37, 114}, {-35, 110}}, {{-50, 114}, {-48, 110}}, {{-65, 114}, {-63, 110}},
+                {{-82, 114}, {-79, 110}}, {{-100, 111}, {-96, 106}}, {{-100, 90}, {-96, 86}}, {{-100, 72}, {-96, 69}},
+                {{-100, 57}, {-96, 55}}, {{-100, 44}, {-96, 42}}, {{-100, 32}, {-96, 31}}, {{-100, 21}, {-96, 20}},
+                {{-100, 10}, {-96, 10}}, {{-100, 0}, {-96, 0}}, {{-100, -10}, {-96, -10}}, {{-100, -21}, {-96, -20}},
+                {{-100, -32}, {-96, -31}}, {{-100, -44}, {-96, -42}}, {{-100, -57}, {-96, -55}}, {{-100, -72}, {-96, -69}},
+                {{-100, -90}, {-96, -86}}, {{-100, -111}, {-96, -106}}, {{-82, -114}, {-79, -110}}, {{-65, -114}, {-63, -110}},
+                {{-50, -114}, {-48, -110}}, {{-37, -114}, {-35, -110}}, {{-24, -114}, {-23, -110}}, {{-11, -114}, {-11, -110}},
+        },
+        .minute_hand = {
+                {{0, -90}, {0, -88}}, {{9, -89}, {9, -87}}, {{18, -88}, {18, -86}}, {{27, -85}, {27, -83}},
+                {{36, -82}, {35, -80}}, {{44, -77}, {43, -76}}, {{52, -72}, {51, -71}}, {{60, -66}, {58, -65}},
+                {{66, -60}, {65, -58}}, {{72, -52}, {71, -51}}, {{77, -45}, {76, -44}}, {{82, -36}, {80, -35}},
+                {{85, -27}, {83, -27}}, {{88, -18}, {86, -18}}, {{89, -9}, {87, -9}}, {{90, 0}, {88, 0}},
+                {{89, 9}, {87, 9}}, {{88, 18}, {86, 18}}, {{85, 27}, {83, 27}}, {{82, 36}, {80, 35}},
+                {{77, 44}, {76, 43}}, {{72, 52}, {71, 51}}, {{66, 60}, {65, 58}}, {{60, 66}, {58, 65}},
+                {{52, 72}, {51, 71}}, {{45, 77}, {44, 76}}, {{36, 82}, {35, 80}}, {{27, 85}, {27, 83}},
+                {{18, 88}, {18, 86}}, {{9, 89}, {9, 87}}, {{0, 90}, {0, 88}}, {{-9, 89}, {-9, 87}},
+                {{-18, 88}, {-18, 86}}, {{-27, 85}, {-27, 83}}, {{-36, 82}, {-35, 80}}, {{-44, 77}, {-43, 76}},
+                {{-52, 72}, {-51, 71}}, {{-60, 66}, {-58, 65}}, {{-66, 60}, {-65, 58}}, {{-72, 52}, {-71, 51}},
+                {{-77, 45}, {-76, 44}}, {{-82, 36}, {-80, 35}}, {{-85, 27}, {-83, 27}}, {{-88, 18}, {-86, 18}},
+                {{-89, 9}, {-87, 9}}, {{-90, 0}, {-88, 0}}, {{-89, -9}, {-87, -9}}, {{-88, -18}, {-86, -18}},
+                {{-85, -27}, {-83, -27}}, {{-82, -36}, {-80, -35}}, {{-77, -44}, {-76, -43}}, {{-72, -52}, {-71, -51}},
+                {{-66, -60}, {-65, -58}}, {{-60, -66}, {-58, -65}}, {{-52, -72}, {-51, -71}}, {{-45, -77}, {-44, -76}},
+                {{-36, -82}, {-35, -80}}, {{-27, -85}, {-27, -83}}, {{-18, -88}, {-18, -86}}, {{-9, -89}, {-9, -87}},
+        },
+        .hour_hand = {
+                {{0, -55}, {0, -53}}, {{4, -54}, {4, -52}}, {{9, -54}, {9, -52}}, {{14, -53}, {13, -51}},
+                {{18, -51}, {18, -49}}, {{23, -49}, {22, -48}}, {{27, -47}, {26, -45}}, {{31, -45}, {30, -43}},
+                {{35, -42}, {34, -40}}, {{38, -38}, {37, -37}}, {{42, -35}, {40, -34}}, {{45, -31}, {43, -30}},
+                {{47, -27}, {45, -26}}, {{49, -23}, {48, -22}}, {{51, -18}, {49, -18}}, {{53, -14}, {51, -13}},
+                {{54, -9}, {52, -9}}, {{54, -4}, {52, -4}}, {{55, 0}, {53, 0}}, {{54, 4}, {52, 4}},
+                {{54, 9}, {52, 9}}, {{53, 14}, {51, 13}}, {{51, 18}, {49, 18}}, {{49, 23}, {48, 22}},
+                {{47, 27}, {45, 26}}, {{45, 31}, {43, 30}}, {{42, 35}, {40, 34}}, {{38, 38}, {37, 37}},
+                {{35, 42}, {34, 40}}, {{31, 45}, {30, 43}}, {{27, 47}, {26, 45}}, {{23, 49}, {22, 48}},
+                {{18, 51}, {18, 49}}, {{14, 53}, {13, 51}}, {{9, 54}, {9, 52}}, {{4, 54}, {4, 52}},
+                {{0, 55}, {0, 53}}, {{-4, 54}, {-4, 52}}, {{-9, 54}, {-9, 52}}, {{-14, 53}, {-13, 51}},
+                {{-18, 51}, {-18, 49}}, {{-23, 49}, {-22, 48}}, {{-27, 47}, {-26, 45}}, {{-31, 45}, {-30, 43}},
+                {{-35, 42}, {-34, 40}}, {{-38, 38}, {-37, 37}}, {{-42, 35}, {-40, 34}}, {{-45, 31}, {-43, 30}},
+                {{-47, 27}, {-45, 26}}, {{-49, 23}, {-48, 22}}, {{-51, 18}, {-49, 18}}, {{-53, 14}, {-51, 13}},
+                {{-54, 9}, {-52, 9}}, {{-54, 4}, {-52, 4}}, {{-55, 0}, {-53, 0}}, {{-54, -4}, {-52, -4}},
+                {{-54, -9}, {-52, -9}}, {{-53, -14}, {-51, -13}}, {{-51, -18}, {-49, -18}}, {{-49, -23}, {-48, -22}},
+                {{-47, -27}, {-45, -26}}, {{-45, -31}, {-43, -30}}, {{-42, -35}, {-40, -34}}, {{-38, -38}, {-37, -37}},
+                {{-35, -42}, {-34, -40}}, {{-31, -45}, {-30, -43}}, {{-27, -47}, {-26, -45}}, {{-23, -49}, {-22, -48}},
+                {{-18, -51}, {-18, -49}}, {{-14, -53}, {-13, -51}}, {{-9, -54}, {-9, -52}}, {{-4, -54}, {-4, -52}},
+        },
+};
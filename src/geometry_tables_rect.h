@@ -0,0 +1,128 @@
+// Generated by host/geometry_tables.c for basalt (144x168), do not edit.
+// Regenerate with: cmake --build <build-dir> --target geometry_tables
+
+#define GEOMETRY_TABLES_LONG_TICKS 1
+
+static const Geometry geometry_circle = {
+        .hour_ticks = {
+                {{0, -72}, {0, -62}}, {{35, -62}, {32, -57}}, {{62, -36}, {57, -33}}, {{72, 0}, {62, 0}},
+                {{62, 35}, {57, 32}}, {{36, 62}, {33, 57}}, {{0, 72}, {0, 62}}, {{-35, 62}, {-32, 57}},
+                {{-62, 36}, {-57, 33}}, {{-72, 0}, {-62, 0}}, {{-62, -35}, {-57, -32}}, {{-36, -62}, {-33, -57}},
+        },
+        .minute_ticks = {
+                {{0, -72}, {0, -69}}, {{7, -71}, {7, -68}}, {{14, -70}, {14, -67}}, {{22, -68}, {21, -65}},
+                {{29, -65}, {28, -63}}, {{35, -62}, {34, -59}}, {{42, -58}, {40, -55}}, {{48, -53}, {46, -51}},
+                {{53, -48}, {51, -46}}, {{58, -42}, {55, -40}}, {{62, -36}, {59, -34}}, {{65, -29}, {63, -28}},
+                {{68, -22}, {65, -21}}, {{70, -14}, {67, -14}}, {{71, -7}, {68, -7}}, {{72, 0}, {69, 0}},
+                {{71, 7}, {68, 7}}, {{70, 14}, {67, 14}}, {{68, 22}, {65, 21}}, {{65, 29}, {63, 28}},
+                {{62, 35}, {59, 34}}, {{58, 42}, {55, 40}}, {{53, 48}, {51, 46}}, {{48, 53}, {46, 51}},
+                {{42, 58}, {40, 55}}, {{36, 62}, {34, 59}}, {{29, 65}, {28, 63}}, {{22, 68}, {21, 65}},
+                {{14, 70}, {14, 67}}, {{7, 71}, {7, 68}}, {{0, 72}, {0, 69}}, {{-7, 71}, {-7, 68}},
+                {{-14, 70}, {-14, 67}}, {{-22, 68}, {-21, 65}}, {{-29, 65}, {-28, 63}}, {{-35, 62}, {-34, 59}},
+                {{-42, 58}, {-40, 55}}, {{-48, 53}, {-46, 51}}, {{-53, 48}, {-51, 46}}, {{-58, 42}, {-55, 40}},
+                {{-62, 36}, {-59, 34}}, {{-65, 29}, {-63, 28}}, {{-68, 22}, {-65, 21}}, {{-70, 14}, {-67, 14}},
+                {{-71, 7}, {-68, 7}}, {{-72, 0}, {-69, 0}}, {{-71, -7}, {-68, -7}}, {{-70, -14}, {-67, -14}},
+                {{-68, -22}, {-65, -21}}, {{-65, -29}, {-63, -28}}, {{-62, -35}, {-59, -34}}, {{-58, -42}, {-55, -40}},
+                {{-53, -48}, {-51, -46}}, {{-48, -53}, {-46, -51}}, {{-42, -58}, {-40, -55}}, {{-36, -62}, {-34, -59}},
+                {{-29, -65}, {-28, -63}}, {{-22, -68}, {-21, -65}}, {{-14, -70}, {-14, -67}}, {{-7, -71}, {-7, -68}},
+        },
+        .minute_hand = {
+                {{0, -62}, {0, -60}}, {{6, -61}, {6, -59}}, {{12, -60}, {12, -58}}, {{19, -58}, {18, -57}},
+                {{25, -56}, {24, -54}}, {{30, -53}, {29, -51}}, {{36, -50}, {35, -48}}, {{41, -46}, {40, -44}},
+                {{46, -41}, {44, -40}}, {{50, -36}, {48, -35}}, {{53, -31}, {51, -30}}, {{56, -25}, {54, -24}},
+                {{58, -19}, {57, -18}}, {{60, -12}, {58, -12}}, {{61, -6}, {59, -6}}, {{62, 0}, {60, 0}},
+                {{61, 6}, {59, 6}}, {{60, 12}, {58, 12}}, {{58, 19}, {57, 18}}, {{56, 25}, {54, 24}},
+                {{53, 30}, {51, 29}}, {{50, 36}, {48, 35}}, {{46, 41}, {44, 40}}, {{41, 46}, {40, 44}},
+                {{36, 50}, {35, 48}}, {{31, 53}, {30, 51}}, {{25, 56}, {24, 54}}, {{19, 58}, {18, 57}},
+                {{12, 60}, {12, 58}}, {{6, 61}, {6, 59}}, {{0, 62}, {0, 60}}, {{-6, 61}, {-6, 59}},
+                {{-12, 60}, {-12, 58}}, {{-19, 58}, {-18, 57}}, {{-25, 56}, {-24, 54}}, {{-30, 53}, {-29, 51}},
+                {{-36, 50}, {-35, 48}}, {{-41, 46}, {-40, 44}}, {{-46, 41}, {-44, 40}}, {{-50, 36}, {-48, 35}},
+                {{-53, 31}, {-51, 30}}, {{-56, 25}, {-54, 24}}, {{-58, 19}, {-57, 18}}, {{-60, 12}, {-58, 12}},
+                {{-61, 6}, {-59, 6}}, {{-62, 0}, {-60, 0}}, {{-61, -6}, {-59, -6}}, {{-60, -12}, {-58, -12}},
+                {{-58, -19}, {-57, -18}}, {{-56, -25}, {-54, -24}}, {{-53, -30}, {-51, -29}}, {{-50, -36}, {-48, -35}},
+                {{-46, -41}, {-44, -40}}, {{-41, -46}, {-40, -44}}, {{-36, -50}, {-35, -48}}, {{-31, -53}, {-30, -51}},
+                {{-25, -56}, {-24, -54}}, {{-19, -58}, {-18, -57}}, {{-12, -60}, {-12, -58}}, {{-6, -61}, {-6, -59}},
+        },
+        .hour_hand = {
+                {{0, -39}, {0, -37}}, {{3, -38}, {3, -36}}, {{6, -38}, {6, -36}}, {{10, -37}, {9, -35}},
+                {{13, -36}, {12, -34}}, {{16, -35}, {15, -33}}, {{19, -33}, {18, -32}}, {{22, -31}, {21, -30}},
+                {{25, -29}, {23, -28}}, {{27, -27}, {26, -26}}, {{29, -25}, {28, -23}}, {{31, -22}, {30, -21}},
+                {{33, -19}, {32, -18}}, {{35, -16}, {33, -15}}, {{36, -13}, {34, -12}}, {{37, -10}, {35, -9}},
+                {{38, -6}, {36, -6}}, {{38, -3}, {36, -3}}, {{39, 0}, {37, 0}}, {{38, 3}, {36, 3}},
+                {{38, 6}, {36, 6}}, {{37, 10}, {35, 9}}, {{36, 13}, {34, 12}}, {{35, 16}, {33, 15}},
+                {{33, 19}, {32, 18}}, {{31, 22}, {30, 21}}, {{29, 25}, {28, 23}}, {{27, 27}, {26, 26}},
+                {{25, 29}, {23, 28}}, {{22, 31}, {21, 30}}, {{19, 33}, {18, 32}}, {{16, 35}, {15, 33}},
+                {{13, 36}, {12, 34}}, {{10, 37}, {9, 35}}, {{6, 38}, {6, 36}}, {{3, 38}, {3, 36}},
+                {{0, 39}, {0, 37}}, {{-3, 38}, {-3, 36}}, {{-6, 38}, {-6, 36}}, {{-10, 37}, {-9, 35}},
+                {{-13, 36}, {-12, 34}}, {{-16, 35}, {-15, 33}}, {{-19, 33}, {-18, 32}}, {{-22, 31}, {-21, 30}},
+                {{-25, 29}, {-23, 28}}, {{-27, 27}, {-26, 26}}, {{-29, 25}, {-28, 23}}, {{-31, 22}, {-30, 21}},
+                {{-33, 19}, {-32, 18}}, {{-35, 16}, {-33, 15}}, {{-36, 13}, {-34, 12}}, {{-37, 10}, {-35, 9}},
+                {{-38, 6}, {-36, 6}}, {{-38, 3}, {-36, 3}}, {{-39, 0}, {-37, 0}}, {{-38, -3}, {-36, -3}},
+                {{-38, -6}, {-36, -6}}, {{-37, -10}, {-35, -9}}, {{-36, -13}, {-34, -12}}, {{-35, -16}, {-33, -15}},
+                {{-33, -19}, {-32, -18}}, {{-31, -22}, {-30, -21}}, {{-29, -25}, {-28, -23}}, {{-27, -27}, {-26, -26}},
+                {{-25, -29}, {-23, -28}}, {{-22, -31}, {-21, -30}}, {{-19, -33}, {-18, -32}}, {{-16, -35}, {-15, -33}},
+                {{-13, -36}, {-12, -34}}, {{-10, -37}, {-9, -35}}, {{-6, -38}, {-6, -36}}, {{-3, -38}, {-3, -36}},
+        },
+};
+
+static const Geometry geometry_square = {
+        .hour_ticks = {
+                {{0, -84}, {0, -72}}, {{48, -84}, {43, -76}}, {{72, -41}, {64, -36}}, {{72, 0}, {60, 0}},
+                {{72, 41}, {64, 36}}, {{48, 84}, {43, 76}}, {{0, 84}, {0, 72}}, {{-48, 84}, {-43, 76}},
+                {{-72, 41}, {-64, 36}}, {{-72, 0}, {-60, 0}}, {{-72, -41}, {-64, -36}}, {{-48, -84}, {-43, -76}},
+        },
+        .minute_ticks = {
+                {{0, -84}, {0, -80}}, {{8, -84}, {8, -80}}, {{17, -84}, {16, -80}}, {{27, -84}, {25, -80}},
+                {{37, -84}, {35, -80}}, {{48, -84}, {46, -80}}, {{61, -84}, {58, -80}}, {{72, -79}, {68, -75}},
+                {{72, -64}, {68, -61}}, {{72, -52}, {68, -49}}, {{72, -41}, {68, -39}}, {{72, -32}, {68, -30}},
+                {{72, -23}, {68, -22}}, {{72, -15}, {68, -14}}, {{72, -7}, {68, -7}}, {{72, 0}, {68, 0}},
+                {{72, 7}, {68, 7}}, {{72, 15}, {68, 14}}, {{72, 23}, {68, 22}}, {{72, 32}, {68, 30}},
+                {{72, 41}, {68, 39}}, {{72, 52}, {68, 49}}, {{72, 64}, {68, 61}}, {{72, 79}, {68, 75}},
+                {{61, 84}, {58, 80}}, {{48, 84}, {46, 80}}, {{37, 84}, {35, 80}}, {{27, 84}, {25, 80}},
+                {{17, 84}, {17, 80}}, {{8, 84}, {8, 80}}, {{0, 84}, {0, 80}}, {{-8, 84}, {-8, 80}},
+                {{-17, 84}, {-16, 80}}, {{-27, 84}, {-25, 80}}, {{-37, 84}, {-35, 80}}, {{-48, 84}, {-46, 80}},
+                {{-61, 84}, {-58, 80}}, {{-72, 79}, {-68, 75}}, {{-72, 64}, {-68, 61}}, {{-72, 52}, {-68, 49}},
+                {{-72, 41}, {-68, 39}}, {{-72, 32}, {-68, 30}}, {{-72, 23}, {-68, 22}}, {{-72, 15}, {-68, 14}},
+                {{-72, 7}, {-68, 7}}, {{-72, 0}, {-68, 0}}, {{-72, -7}, {-68, -7}}, {{-72, -15}, {-68, -14}},
+                {{-72, -23}, {-68, -22}}, {{-72, -32}, {-68, -30}}, {{-72, -41}, {-68, -39}}, {{-72, -52}, {-68, -49}},
+                {{-72, -64}, {-68, -61}}, {{-72, -79}, {-68, -75}}, {{-61, -84}, {-58, -80}}, {{-48, -84}, {-46, -80}},
+                {{-37, -84}, {-35, -80}}, {{-27, -84}, {-25, -80}}, {{-17, -84}, {-17, -80}}, {{-8, -84}, {-8, -80}},
+        },
+        .minute_hand = {
+                {{0, -62}, {0, -60}}, {{6, -61}, {6, -59}}, {{12, -60}, {12, -58}}, {{19, -58}, {18, -57}},
+                {{25, -56}, {24, -54}}, {{30, -53}, {29, -51}}, {{36, -50}, {35, -48}}, {{41, -46}, {40, -44}},
+                {{46, -41}, {44, -40}}, {{50, -36}, {48, -35}}, {{53, -31}, {51, -30}}, {{56, -25}, {54, -24}},
+                {{58, -19}, {57, -18}}, {{60, -12}, {58, -12}}, {{61, -6}, {59, -6}}, {{62, 0}, {60, 0}},
+                {{61, 6}, {59, 6}}, {{60, 12}, {58, 12}}, {{58, 19}, {57, 18}}, {{56, 25}, {54, 24}},
+                {{53, 30}, {51, 29}}, {{50, 36}, {48, 35}}, {{46, 41}, {44, 40}}, {{41, 46}, {40, 44}},
+                {{36, 50}, {35, 48}}, {{31, 53}, {30, 51}}, {{25, 56}, {24, 54}}, {{19, 58}, {18, 57}},
+                {{12, 60}, {12, 58}}, {{6, 61}, {6, 59}}, {{0, 62}, {0, 60}}, {{-6, 61}, {-6, 59}},
+                {{-12, 60}, {-12, 58}}, {{-19, 58}, {-18, 57}}, {{-25, 56}, {-24, 54}}, {{-30, 53}, {-29, 51}},
+                {{-36, 50}, {-35, 48}}, {{-41, 46}, {-40, 44}}, {{-46, 41}, {-44, 40}}, {{-50, 36}, {-48, 35}},
+                {{-53, 31}, {-51, 30}}, {{-56, 25}, {-54, 24}}, {{-58, 19}, {-57, 18}}, {{-60, 12}, {-58, 12}},
+                {{-61, 6}, {-59, 6}}, {{-62, 0}, {-60, 0}}, {{-61, -6}, {-59, -6}}, {{-60, -12}, {-58, -12}},
+                {{-58, -19}, {-57, -18}}, {{-56, -25}, {-54, -24}}, {{-53, -30}, {-51, -29}}, {{-50, -36}, {-48, -35}},
+                {{-46, -41}, {-44, -40}}, {{-41, -46}, {-40, -44}}, {{-36, -50}, {-35, -48}}, {{-31, -53}, {-30, -51}},
+                {{-25, -56}, {-24, -54}}, {{-19, -58}, {-18, -57}}, {{-12, -60}, {-12, -58}}, {{-6, -61}, {-6, -59}},
+        },
+        .hour_hand = {
+                {{0, -39}, {0, -37}}, {{3, -38}, {3, -36}}, {{6, -38}, {6, -36}}, {{10, -37}, {9, -35}},
+                {{13, -36}, {12, -34}}, {{16, -35}, {15, -33}}, {{19, -33}, {18, -32}}, {{22, -31}, {21, -30}},
+                {{25, -29}, {23, -28}}, {{27, -27}, {26, -26}}, {{29, -25}, {28, -23}}, {{31, -22}, {30, -21}},
+                {{33, -19}, {32, -18}}, {{35, -16}, {33, -15}}, {{36, -13}, {34, -12}}, {{37, -10}, {35, -9}},
+                {{38, -6}, {36, -6}}, {{38, -3}, {36, -3}}, {{39, 0}, {37, 0}}, {{38, 3}, {36, 3}},
+                {{38, 6}, {36, 6}}, {{37, 10}, {35, 9}}, {{36, 13}, {34, 12}}, {{35, 16}, {33, 15}},
+                {{33, 19}, {32, 18}}, {{31, 22}, {30, 21}}, {{29, 25}, {28, 23}}, {{27, 27}, {26, 26}},
+                {{25, 29}, {23, 28}}, {{22, 31}, {21, 30}}, {{19, 33}, {18, 32}}, {{16, 35}, {15, 33}},
+                {{13, 36}, {12, 34}}, {{10, 37}, {9, 35}}, {{6, 38}, {6, 36}}, {{3, 38}, {3, 36}},
+                {{0, 39}, {0, 37}}, {{-3, 38}, {-3, 36}}, {{-6, 38}, {-6, 36}}, {{-10, 37}, {-9, 35}},
+                {{-13, 36}, {-12, 34}}, {{-16, 35}, {-15, 33}}, {{-19, 33}, {-18, 32}}, {{-22, 31}, {-21, 30}},
+                {{-25, 29}, {-23, 28}}, {{-27, 27}, {-26, 26}}, {{-29, 25}, {-28, 23}}, {{-31, 22}, {-30, 21}},
+                {{-33, 19}, {-32, 18}}, {{-35, 16}, {-33, 15}}, {{-36, 13}, {-34, 12}}, {{-37, 10}, {-35, 9}},
+                {{-38, 6}, {-36, 6}}, {{-38, 3}, {-36, 3}}, {{-39, 0}, {-37, 0}}, {{-38, -3}, {-36, -3}},
+                {{-38, -6}, {-36, -6}}, {{-37, -10}, {-35, -9}}, {{-36, -13}, {-34, -12}}, {{-35, -16}, {-33, -15}},
+                {{-33, -19}, {-32, -18}}, {{-31, -22}, {-30, -21}}, {{-29, -25}, {-28, -23}}, {{-27, -27}, {-26, -26}},
+                {{-25, -29}, {-23, -28}}, {{-22, -31}, {-21, -30}}, {{-19, -33}, {-18, -32}}, {{-16, -35}, {-15, -33}},
+                {{-13, -36}, {-12, -34}}, {{-10, -37}, {-9, -35}}, {{-6, -38}, {-6, -36}}, {{-3, -38}, {-3, -36}},
+        },
+};
@@ -0,0 +1,66 @@
+// Generated by host/geometry_tables.c for chalk (180x180), do not edit.
+// Regenerate with: cmake --build <build-dir> --target geometry_tables
+
+#define GEOMETRY_TABLES_LONG_TICKS 1
+
+static const Geometry geometry_circle = {
+        .hour_ticks = {
+                {{0, -93}, {0, -78}}, {{46, -80}, {40, -71}}, {{80, -46}, {71, -41}}, {{93, 0}, {78, 0}},
+                {{80, 46}, {71, 40}}, {{46, 80}, {41, 71}}, {{0, 93}, {0, 78}}, {{-46, 80}, {-40, 71}},
+                {{-80, 46}, {-71, 41}}, {{-93, 0}, {-78, 0}}, {{-80, -46}, {-71, -40}}, {{-46, -80}, {-41, -71}},
+        },
+        .minute_ticks = {
+                {{0, -93}, {0, -85}}, {{9, -92}, {8, -84}}, {{19, -90}, {17, -83}}, {{28, -88}, {26, -80}},
+                {{37, -84}, {34, -77}}, {{46, -80}, {42, -73}}, {{54, -75}, {49, -68}}, {{62, -69}, {56, -63}},
+                {{69, -62}, {63, -56}}, {{75, -54}, {68, -49}}, {{80, -46}, {73, -42}}, {{84, -37}, {77, -34}},
+                {{88, -28}, {80, -26}}, {{90, -19}, {83, -17}}, {{92, -9}, {84, -8}}, {{93, 0}, {85, 0}},
+                {{92, 9}, {84, 8}}, {{90, 19}, {83, 17}}, {{88, 28}, {80, 26}}, {{84, 37}, {77, 34}},
+                {{80, 46}, {73, 42}}, {{75, 54}, {68, 49}}, {{69, 62}, {63, 56}}, {{62, 69}, {56, 63}},
+                {{54, 75}, {49, 68}}, {{46, 80}, {42, 73}}, {{37, 84}, {34, 77}}, {{28, 88}, {26, 80}},
+                {{19, 90}, {17, 83}}, {{9, 92}, {8, 84}}, {{0, 93}, {0, 85}}, {{-9, 92}, {-8, 84}},
+                {{-19, 90}, {-17, 83}}, {{-28, 88}, {-26, 80}}, {{-37, 84}, {-34, 77}}, {{-46, 80}, {-42, 73}},
+                {{-54, 75}, {-49, 68}}, {{-62, 69}, {-56, 63}}, {{-69, 62}, {-63, 56}}, {{-75, 54}, {-68, 49}},
+                {{-80, 46}, {-73, 42}}, {{-84, 37}, {-77, 34}}, {{-88, 28}, {-80, 26}}, {{-90, 19}, {-83, 17}},
+                {{-92, 9}, {-84, 8}}, {{-93, 0}, {-85, 0}}, {{-92, -9}, {-84, -8}}, {{-90, -19}, {-83, -17}},
+                {{-88, -28}, {-80, -26}}, {{-84, -37}, {-77, -34}}, {{-80, -46}, {-73, -42}}, {{-75, -54}, {-68, -49}},
+                {{-69, -62}, {-63, -56}}, {{-62, -69}, {-56, -63}}, {{-54, -75}, {-49, -68}}, {{-46, -80}, {-42, -73}},
+                {{-37, -84}, {-34, -77}}, {{-28, -88}, {-26, -80}}, {{-19, -90}, {-17, -83}}, {{-9, -92}, {-8, -84}},
+        },
+        .minute_hand = {
+                {{0, -74}, {0, -70}}, {{7, -73}, {7, -69}}, {{15, -72}, {14, -68}}, {{22, -70}, {21, -66}},
+                {{30, -67}, {28, -63}}, {{36, -64}, {34, -60}}, {{43, -59}, {41, -56}}, {{49, -54}, {46, -52}},
+                {{54, -49}, {52, -46}}, {{59, -43}, {56, -41}}, {{64, -37}, {60, -35}}, {{67, -30}, {63, -28}},
+                {{70, -22}, {66, -21}}, {{72, -15}, {68, -14}}, {{73, -7}, {69, -7}}, {{74, 0}, {70, 0}},
+                {{73, 7}, {69, 7}}, {{72, 15}, {68, 14}}, {{70, 22}, {66, 21}}, {{67, 30}, {63, 28}},
+                {{64, 36}, {60, 34}}, {{59, 43}, {56, 41}}, {{54, 49}, {52, 46}}, {{49, 54}, {46, 52}},
+                {{43, 59}, {41, 56}}, {{37, 64}, {35, 60}}, {{30, 67}, {28, 63}}, {{22, 70}, {21, 66}},
+                {{15, 72}, {14, 68}}, {{7, 73}, {7, 69}}, {{0, 74}, {0, 70}}, {{-7, 73}, {-7, 69}},
+                {{-15, 72}, {-14, 68}}, {{-22, 70}, {-21, 66}}, {{-30, 67}, {-28, 63}}, {{-36, 64}, {-34, 60}},
+                {{-43, 59}, {-41, 56}}, {{-49, 54}, {-46, 52}}, {{-54, 49}, {-52, 46}}, {{-59, 43}, {-56, 41}},
+                {{-64, 37}, {-60, 35}}, {{-67, 30}, {-63, 28}}, {{-70, 22}, {-66, 21}}, {{-72, 15}, {-68, 14}},
+                {{-73, 7}, {-69, 7}}, {{-74, 0}, {-70, 0}}, {{-73, -7}, {-69, -7}}, {{-72, -15}, {-68, -14}},
+                {{-70, -22}, {-66, -21}}, {{-67, -30}, {-63, -28}}, {{-64, -36}, {-60, -34}}, {{-59, -43}, {-56, -41}},
+                {{-54, -49}, {-52, -46}}, {{-49, -54}, {-46, -52}}, {{-43, -59}, {-41, -56}}, {{-37, -64}, {-35, -60}},
+                {{-30, -67}, {-28, -63}}, {{-22, -70}, {-21, -66}}, {{-15, -72}, {-14, -68}}, {{-7, -73}, {-7, -69}},
+        },
+        .hour_hand = {
+                {{0, -49}, {0, -47}}, {{4, -48}, {4, -46}}, {{8, -48}, {8, -46}}, {{12, -47}, {12, -45}},
+                {{16, -46}, {16, -44}}, {{20, -44}, {19, -42}}, {{24, -42}, {23, -40}}, {{28, -40}, {26, -38}},
+                {{31, -37}, {30, -36}}, {{34, -34}, {33, -33}}, {{37, -31}, {36, -30}}, {{40, -28}, {38, -26}},
+                {{42, -24}, {40, -23}}, {{44, -20}, {42, -19}}, {{46, -16}, {44, -16}}, {{47, -12}, {45, -12}},
+                {{48, -8}, {46, -8}}, {{48, -4}, {46, -4}}, {{49, 0}, {47, 0}}, {{48, 4}, {46, 4}},
+                {{48, 8}, {46, 8}}, {{47, 12}, {45, 12}}, {{46, 16}, {44, 16}}, {{44, 20}, {42, 19}},
+                {{42, 24}, {40, 23}}, {{40, 28}, {38, 26}}, {{37, 31}, {36, 30}}, {{34, 34}, {33, 33}},
+                {{31, 37}, {30, 36}}, {{28, 40}, {26, 38}}, {{24, 42}, {23, 40}}, {{20, 44}, {19, 42}},
+                {{16, 46}, {16, 44}}, {{12, 47}, {12, 45}}, {{8, 48}, {8, 46}}, {{4, 48}, {4, 46}},
+                {{0, 49}, {0, 47}}, {{-4, 48}, {-4, 46}}, {{-8, 48}, {-8, 46}}, {{-12, 47}, {-12, 45}},
+                {{-16, 46}, {-16, 44}}, {{-20, 44}, {-19, 42}}, {{-24, 42}, {-23, 40}}, {{-28, 40}, {-26, 38}},
+                {{-31, 37}, {-30, 36}}, {{-34, 34}, {-33, 33}}, {{-37, 31}, {-36, 30}}, {{-40, 28}, {-38, 26}},
+                {{-42, 24}, {-40, 23}}, {{-44, 20}, {-42, 19}}, {{-46, 16}, {-44, 16}}, {{-47, 12}, {-45, 12}},
+                {{-48, 8}, {-46, 8}}, {{-48, 4}, {-46, 4}}, {{-49, 0}, {-47, 0}}, {{-48, -4}, {-46, -4}},
+                {{-48, -8}, {-46, -8}}, {{-47, -12}, {-45, -12}}, {{-46, -16}, {-44, -16}}, {{-44, -20}, {-42, -19}},
+                {{-42, -24}, {-40, -23}}, {{-40, -28}, {-38, -26}}, {{-37, -31}, {-36, -30}}, {{-34, -34}, {-33, -33}},
+                {{-31, -37}, {-30, -36}}, {{-28, -40}, {-26, -38}}, {{-24, -42}, {-23, -40}}, {{-20, -44}, {-19, -42}},
+                {{-16, -46}, {-16, -44}}, {{-12, -47}, {-12, -45}}, {{-8, -48}, {-8, -46}}, {{-4, -48}, {-4, -46}},
+        },
+};
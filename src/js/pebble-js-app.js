@@ -32,12 +32,126 @@ function getUToken() {
     }
 }
 
+// messages to the watch are sent one at a time; a message the watch does not acknowledge is sent again up to
+// SEND_RETRIES times, after SEND_RETRY_DELAY ms (doubling with every retry)
+var SEND_RETRIES = 5;
+var SEND_RETRY_DELAY = 500;
+
+/** Messages waiting to be sent ({kind, data, success, failure, attempts}), and the one being sent. */
+var sendQueue = [];
+var sendInFlight = null;
+
+// values of MSG_KEY_JS_READY (also in src/obsidian.h): the phone is ready, and it is fetching the weather already
+var JS_READY = 1;
+var JS_READY_FETCHING = 2;
+
+/**
+ * What the phone knows about the weather on the watch: {received (in ms), refresh (in minutes), forecastHours,
+ * forecastStart (in ms), forecastCount}, or null.  The watch sends when it last received weather and its refresh
+ * policy with every weather request (MSG_KEY_WEATHER_STATE); the forecast is recorded when the watch acknowledges it.
+ */
+function readWatchWeather() {
+    try {
+        return JSON.parse(localStorage.getItem("WATCH_WEATHER"));
+    } catch (e) {
+        return null;
+    }
+}
+
+function writeWatchWeather(state) {
+    localStorage.setItem("WATCH_WEATHER", JSON.stringify(state));
+}
+
+/** Does the watch want new weather (as far as the phone knows)?  The same policy as update_weather in the watch. */
+function watchWeatherDue() {
+    var state = readWatchWeather();
+    if (state === null || state.refresh == 0) return false;
+    var now = new Date().getTime();
+    var next = state.received + state.refresh * 60000;
+    var forecastNext = state.forecastStart + state.forecastHours * 3600000;
+    var coversNow = state.forecastStart <= now && now < state.forecastStart + state.forecastCount * 3600000;
+    if (coversNow && forecastNext > next) {
+        next = forecastNext;
+    }
+    return now >= next;
+}
+
+/** Record the weather in a message the watch acknowledged. */
+function weatherAcknowledged(data) {
+    if ("MSG_KEY_FORECAST" in data) {
+        var bytes = data["MSG_KEY_FORECAST"];
+        var state = readWatchWeather();
+        if (state !== null) {
+            state.received = new Date().getTime();
+            state.forecastStart = ((bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24)) >>> 0) * 1000;
+            state.forecastCount = bytes[4];
+            writeWatchWeather(state);
+        }
+    }
+}
+
+/**
+ * Queue a message to the watch.  The kind says what the message is about ("ready", "config" or "weather"): only the
+ * newest message of a kind is sent, and it replaces a queued one.  Weather is sent even if the watch has it already:
+ * every weather message answers a request of the watch (MSG_KEY_FETCH_WEATHER, or the promise of JS_READY_FETCHING),
+ * and the watch only takes a request as answered when the answer arrives.  The callbacks are called once the watch
+ * acknowledged the message, or it was given up.
+ */
+function sendToWatch(kind, data, success, failure) {
+    sendQueue = sendQueue.filter(function (message) {
+        return message.kind != kind;
+    });
+    sendQueue.push({kind: kind, data: data, success: success, failure: failure, attempts: 0});
+    sendNextMessage();
+}
+
+function sendNextMessage() {
+    if (sendInFlight !== null || sendQueue.length == 0) return;
+    var message = sendInFlight = sendQueue.shift();
+    message.attempts += 1;
+    Pebble.sendAppMessage(message.data, function () {
+        sendInFlight = null;
+        weatherAcknowledged(message.data);
+        if (message.success) message.success();
+        sendNextMessage();
+    }, function (e) {
+        sendInFlight = null;
+        var superseded = sendQueue.some(function (queued) {
+            return queued.kind == message.kind;
+        });
+        if (superseded) {
+            // a newer message of the same kind is queued already
+        } else if (message.attempts <= SEND_RETRIES) {
+            console.log('[ info/app ] message not acknowledged, retry ' + message.attempts + ': ' +
+                JSON.stringify(e.error || e));
+            sendQueue.unshift(message);
+            setTimeout(sendNextMessage, SEND_RETRY_DELAY << (message.attempts - 1));
+            return;
+        } else {
+            console.log('[ info/app ] message failed: ' + JSON.stringify(message.data));
+            if (message.failure) message.failure(e);
+        }
+        sendNextMessage();
+    });
+}
+
 Pebble.addEventListener('ready', function () {
     console.log('[ info/app ] PebbleKit JS ready!');
-    var data = {
-        "MSG_KEY_JS_READY": 1
-    };
-    Pebble.sendAppMessage(data);
+    if (!watchWeatherDue()) {
+        sendToWatch("ready", {"MSG_KEY_JS_READY": JS_READY});
+        return;
+    }
+    // the watch wants new weather: send it along if it is in the cache, or tell the watch that it is on its way (so
+    // that it does not ask for it) and fetch it
+    var data = cachedForecastMessage();
+    if (data !== null) {
+        console.log('[ info/app ] weather from the cache, sent with ready');
+        data["MSG_KEY_JS_READY"] = JS_READY;
+        sendToWatch("ready", data);
+    } else {
+        sendToWatch("ready", {"MSG_KEY_JS_READY": JS_READY_FETCHING});
+        requestWeather();
+    }
 });
 
 Pebble.addEventListener('showConfiguration', function () {
@@ -56,6 +170,71 @@ Pebble.addEventListener('showConfiguration', function () {
     Pebble.openURL(url);
 });
 
+// layout of the configuration blob sent in MSG_KEY_CONFIG: a version byte, followed by these values (the size is
+// in bytes, 16-bit values are little endian); the layout is also in config_fields in src/settings.c
+var CONFIG_VERSION = 1;
+var CONFIG_LAYOUT = [
+    ["CONFIG_COLOR_OUTER_BACKGROUND", 1],
+    ["CONFIG_COLOR_INNER_BACKGROUND", 1],
+    ["CONFIG_COLOR_MINUTE_HAND", 1],
+    ["CONFIG_COLOR_INNER_MINUTE_HAND", 1],
+    ["CONFIG_COLOR_HOUR_HAND", 1],
+    ["CONFIG_COLOR_INNER_HOUR_HAND", 1],
+    ["CONFIG_COLOR_CIRCLE", 1],
+    ["CONFIG_COLOR_TICKS", 1],
+    ["CONFIG_COLOR_DAY_OF_WEEK", 1],
+    ["CONFIG_COLOR_DATE", 1],
+    ["CONFIG_BATTERY_LOGO", 1],
+    ["CONFIG_COLOR_BATTERY_LOGO", 1],
+    ["CONFIG_COLOR_BATTERY_30", 1],
+    ["CONFIG_COLOR_BATTERY_20", 1],
+    ["CONFIG_COLOR_BATTERY_10", 1],
+    ["CONFIG_COLOR_BATTERY_BG_30", 1],
+    ["CONFIG_COLOR_BATTERY_BG_20", 1],
+    ["CONFIG_COLOR_BATTERY_BG_10", 1],
+    ["CONFIG_COLOR_BLUETOOTH_LOGO", 1],
+    ["CONFIG_COLOR_BLUETOOTH_LOGO_2", 1],
+    ["CONFIG_BLUETOOTH_LOGO", 1],
+    ["CONFIG_VIBRATE_DISCONNECT", 1],
+    ["CONFIG_VIBRATE_RECONNECT", 1],
+    ["CONFIG_MESSAGE_DISCONNECT", 1],
+    ["CONFIG_MESSAGE_RECONNECT", 1],
+    ["CONFIG_MINUTE_TICKS", 1],
+    ["CONFIG_HOUR_TICKS", 1],
+    ["CONFIG_COLOR_WEATHER", 1],
+    ["CONFIG_WEATHER_REFRESH", 2],
+    ["CONFIG_WEATHER_EXPIRATION", 2],
+    ["CONFIG_SQUARE", 1],
+    ["CONFIG_SECONDS", 1],
+    ["CONFIG_COLOR_SECONDS", 1],
+    ["CONFIG_DATE_FORMAT", 1]
+];
+
+/** Pack the configuration values into a byte array (see CONFIG_LAYOUT) */
+function packConfig(config) {
+    var bytes = [CONFIG_VERSION];
+    for (var i = 0; i < CONFIG_LAYOUT.length; i++) {
+        var value = config[CONFIG_LAYOUT[i][0]] | 0;
+        bytes.push(value & 0xff);
+        if (CONFIG_LAYOUT[i][1] == 2) {
+            bytes.push((value >> 8) & 0xff);
+        }
+    }
+    return bytes;
+}
+
+// the settings the weather depends on: if one of them changes, the watch needs the weather again
+var WEATHER_SETTINGS = [
+    "CONFIG_WEATHER_LOCAL",
+    "CONFIG_WEATHER_MODE_LOCAL",
+    "CONFIG_WEATHER_UNIT_LOCAL",
+    "CONFIG_WEATHER_SOURCE_LOCAL",
+    "CONFIG_WEATHER_APIKEY_LOCAL",
+    "CONFIG_WEATHER_LOCATION_LOCAL",
+    "CONFIG_WEATHER_REFRESH",
+    "CONFIG_WEATHER_EXPIRATION"
+];
+
 Pebble.addEventListener('webviewclosed', function (e) {
     var urlconfig = JSON.parse(decodeURIComponent(e.response));
 
@@ -105,7 +284,14 @@ Pebble.addEventListener('webviewclosed', function (e) {
     };
     var config = {};
     var fullconfig = {};
+    // a configuration that replaces one not acknowledged yet keeps its weather flag
+    var weatherChanged = sendQueue.concat(sendInFlight !== null ? [sendInFlight] : []).some(function (message) {
+        return message.kind == "config" && "MSG_KEY_WEATHER_INVALID" in message.data;
+    });
     for (var k in keys) {
+        if (WEATHER_SETTINGS.indexOf(k) != -1 && localStorage.getItem(k) !== String(urlconfig[keys[k]])) {
+            weatherChanged = true;
+        }
         fullconfig[k] = urlconfig[keys[k]];
         if (k.indexOf("_LOCAL") == -1) {
             // we can only deal with integers, but let's make sure they are all ints
@@ -125,7 +311,21 @@ Pebble.addEventListener('webviewclosed', function (e) {
 
     console.log('[ info/app ] Configuration page returned: ' + JSON.stringify(fullconfig));
 
-    Pebble.sendAppMessage(config, function () {
+    // all values go in one byte array
+    var data = {
+        "MSG_KEY_CONFIG": packConfig(config)
+    };
+    // the watch drops its forecast when the weather settings change, so it needs the weather again
+    if (weatherChanged) {
+        data["MSG_KEY_WEATHER_INVALID"] = 1;
+        var state = readWatchWeather();
+        if (state !== null) {
+            state.received = 0;
+            state.forecastCount = 0;
+            writeWatchWeather(state);
+        }
+    }
+    sendToWatch("config", data, function () {
         console.log('[ info/app ] Send successful: ' + JSON.stringify(config));
     }, function(e) {
         console.log(JSON.stringify(config));
@@ -238,43 +438,205 @@ function failedWeatherCheck(err) {
     var data = {
         "MSG_KEY_WEATHER_FAILED": 1
     };
-    Pebble.sendAppMessage(data);
+    sendToWatch("weather", data);
 }
 
-function fetchWeather(latitude, longitude) {
+// number of hourly entries in a forecast (also FORECAST_HOURS in src/obsidian.h)
+var FORECAST_HOURS = 24;
 
-    var now = new Date();
+/** Summarizes hourly entries ({time, temp, icon}) per day: the maximum temperature and the icon closest to noon. */
+function dailyFromHourly(hourly) {
+    var days = [];
+    var noonDistance = [];
+    for (var i = 0; i < hourly.length; i++) {
+        var date = new Date(hourly[i].time);
+        var last = days.length - 1;
+        var distance = Math.abs(date.getHours() - 12);
+        if (last < 0 || !sameDate(new Date(days[last].time), date)) {
+            days.push({time: hourly[i].time, temp: hourly[i].temp, icon: hourly[i].icon});
+            noonDistance.push(distance);
+        } else {
+            days[last].temp = Math.max(days[last].temp, hourly[i].temp);
+            if (distance < noonDistance[last]) {
+                days[last].icon = hourly[i].icon;
+                noonDistance[last] = distance;
+            }
+        }
+    }
+    return days;
+}
 
-    var daily;
-    var mode = +readConfig("CONFIG_WEATHER_MODE_LOCAL");
-    if (mode == 3) {
-        // use current weather information after 2pm, until 4am
-        daily = !(now.getHours() >= 14 || now.getHours() <= 3);
-    } else {
-        daily = mode == 2; // daily mode
+// the weather fetched from a provider is cached, and used for positions within WEATHER_CACHE_DISTANCE km of the
+// cached one for WEATHER_CACHE_MAX_AGE minutes; the cache keeps WEATHER_CACHE_SIZE entries (locations and providers)
+var WEATHER_CACHE_DISTANCE = 3;
+var WEATHER_CACHE_MAX_AGE = 60;
+var WEATHER_CACHE_SIZE = 4;
+
+/** Approximate distance between two positions, in km. */
+function distance(latitude1, longitude1, latitude2, longitude2) {
+    var toRadians = Math.PI / 180;
+    var x = (longitude2 - longitude1) * toRadians * Math.cos((latitude1 + latitude2) / 2 * toRadians);
+    var y = (latitude2 - latitude1) * toRadians;
+    return Math.sqrt(x * x + y * y) * 6371;
+}
+
+/**
+ * The weather cache: a list of {source, latitude, longitude, time (in ms), hourly, daily}, most recent first.  The
+ * positions are rounded to two decimals, the hourly and daily weather is as passed to sendForecast (in fetchWeather),
+ * so that the mode and unit are only applied when answering.
+ */
+function readWeatherCache() {
+    try {
+        return JSON.parse(localStorage.getItem("WEATHER_CACHE")) || [];
+    } catch (e) {
+        return [];
     }
+}
 
-    /** Callback on successful determination of weather conditions. */
-    var success = function(temp, icon) {
+/** The most recent cache entry for the source near the given position that is fresh enough, or null. */
+function findCachedWeather(source, latitude, longitude) {
+    var cache = readWeatherCache();
+    var now = new Date().getTime();
+    for (var i = 0; i < cache.length; i++) {
+        var entry = cache[i];
+        if (entry.source == source && now - entry.time <= WEATHER_CACHE_MAX_AGE * 60000 &&
+            distance(entry.latitude, entry.longitude, +latitude, +longitude) <= WEATHER_CACHE_DISTANCE) {
+            return entry;
+        }
+    }
+    return null;
+}
+
+/** Add weather for the source at the given position to the cache (replacing the entry with the same key). */
+function storeCachedWeather(source, latitude, longitude, hourly, daily) {
+    var entry = {
+        source: source,
+        latitude: Math.round(latitude * 100) / 100,
+        longitude: Math.round(longitude * 100) / 100,
+        time: new Date().getTime(),
+        hourly: hourly,
+        daily: daily
+    };
+    var cache = readWeatherCache().filter(function (old) {
+        return !(old.source == entry.source && old.latitude == entry.latitude && old.longitude == entry.longitude);
+    });
+    cache.unshift(entry);
+    localStorage.setItem("WEATHER_CACHE", JSON.stringify(cache.slice(0, WEATHER_CACHE_SIZE)));
+}
+
+/**
+ * The message with the weather for the next FORECAST_HOURS hours, as a byte array: the start time (4 bytes, little
+ * endian), the number of hours, and the icon and temperature for every hour.  Both arguments are lists of {time (in
+ * ms), temp (in celsius), icon}: hourly (or current) conditions, and daily forecasts.  Returns null if they do not
+ * cover the current hour.
+ */
+function forecastMessage(hourly, daily) {
+    var now = new Date();
+    var mode = +readConfig("CONFIG_WEATHER_MODE_LOCAL");
+
+    /** Is the weather for the given time the forecast for the whole day? */
+    var isDaily = function (date) {
+        if (mode == 3) {
+            // use current weather information after 2pm, until 4am
+            return !(date.getHours() >= 14 || date.getHours() <= 3);
+        }
+        return mode == 2; // daily mode
+    };
+
+    /** The entry closest to the given time (in ms), if there is one within 3 hours. */
+    var closest = function (entries, time) {
+        var best = null;
+        for (var i = 0; i < entries.length; i++) {
+            if (best === null || Math.abs(entries[i].time - time) < Math.abs(best.time - time)) {
+                best = entries[i];
+            }
+        }
+        if (best !== null && Math.abs(best.time - time) > 3 * 3600 * 1000) return null;
+        return best;
+    };
+
+    // the watch plays the forecast back by UTC hour (see play_forecast_hour in src/settings.c), which is not a local
+    // hour in timezones with a half or quarter hour offset
+    var start = new Date(now.getTime());
+    start.setUTCMinutes(0, 0, 0);
+    var startSeconds = Math.floor(start.getTime() / 1000);
+    var bytes = [startSeconds & 0xff, (startSeconds >> 8) & 0xff, (startSeconds >> 16) & 0xff,
+        (startSeconds >>> 24) & 0xff, 0];
+    var count = 0;
+    for (var h = 0; h < FORECAST_HOURS; h++) {
+        var date = new Date(start.getTime() + h * 3600 * 1000);
+        var useDaily = isDaily(date);
+        var entry = null;
+        if (useDaily) {
+            for (var i = 0; i < daily.length; i++) {
+                if (sameDate(new Date(daily[i].time), date)) {
+                    entry = daily[i];
+                    break;
+                }
+            }
+        } else {
+            // the current hour uses the conditions closest to now
+            entry = closest(hourly, h == 0 ? now.getTime() : date.getTime());
+        }
+        if (entry === null) break;
+
+        var temp = entry.temp;
         if (+readConfig("CONFIG_WEATHER_UNIT_LOCAL") == 2) {
             temp = temp * 9.0/5.0 + 32.0;
         }
         temp = Math.round(temp);
+        var icon = entry.icon;
         if (!icon) {
             icon = "a";
         }
-        if (daily) {
+        if (useDaily) {
             icon = icon.toLowerCase();
-        } else if (now.getHours() >= 20) {
+        } else if (date.getHours() >= 20) {
             icon = icon.toUpperCase();
         }
-        icon = icon.charCodeAt(0);
-        var data = {
-            "MSG_KEY_WEATHER_ICON": icon,
-            "MSG_KEY_WEATHER_TEMP": temp
-        };
-        console.log('[ info/app ] weather send: temp=' + temp + ", icon=" + String.fromCharCode(icon) + ".");
-        Pebble.sendAppMessage(data);
+        bytes.push(icon.charCodeAt(0), temp & 0xff);
+        count += 1;
+    }
+    if (count == 0) {
+        return null;
+    }
+    bytes[4] = count;
+    var data = {
+        "MSG_KEY_FORECAST": bytes
+    };
+    console.log('[ info/app ] weather forecast: ' + count + ' hours, temp=' + (bytes[6] << 24 >> 24) + ", icon=" +
+        String.fromCharCode(bytes[5]) + ".");
+    return data;
+}
+
+function fetchWeather(latitude, longitude) {
+
+    var now = new Date();
+
+    /** Sends the weather (see forecastMessage), returns false if there is none for the current hour. */
+    var sendForecast = function (hourly, daily) {
+        var data = forecastMessage(hourly, daily);
+        if (data === null) {
+            return false;
+        }
+        sendToWatch("weather", data);
+        return true;
+    };
+
+    var source = +readConfig("CONFIG_WEATHER_SOURCE_LOCAL");
+    var cached = findCachedWeather(source, latitude, longitude);
+    if (cached !== null && sendForecast(cached.hourly, cached.daily)) {
+        console.log('[ info/app ] weather from the cache (' + Math.round((now.getTime() - cached.time) / 60000) +
+            ' minutes old)');
+        return;
+    }
+
+    /** Callback on successful determination of weather conditions (see sendForecast for the arguments). */
+    var success = function (hourly, daily) {
+        storeCachedWeather(source, latitude, longitude, hourly, daily);
+        if (!sendForecast(hourly, daily)) {
+            failedWeatherCheck("no forecast for the current hour");
+        }
     };
 
     var runRequest = function (url, parse) {
@@ -304,101 +666,138 @@ function fetchWeather(latitude, longitude) {
         req.send(null);
     };
 
-    var source = +readConfig("CONFIG_WEATHER_SOURCE_LOCAL");
     var apikey = readConfig("CONFIG_WEATHER_APIKEY_LOCAL");
-    console.log('[ info/app ] requesting weather information (' + (daily ? "daily" : "currently") + ')...');
+    console.log('[ info/app ] requesting weather forecast (source ' + source + ')...');
     if (source == 1) {
+        // 3-hourly forecast for the next days
         var query = "lat=" + latitude + "&lon=" + longitude;
-        query += "&cnt=1&appid=fa5280deac4b98572739388b55cd7591";
-        query = "http://api.openweathermap.org/data/2.5/weather?" + query;
+        query += "&appid=fa5280deac4b98572739388b55cd7591";
+        query = "http://api.openweathermap.org/data/2.5/forecast?" + query;
         runRequest(query, function (response) {
-            var temp = response.main.temp - 273.15;
-            if (daily) temp = response.main.temp_max - 273.15;
-            var icon = parseIconOpenWeatherMap(response.weather[0].icon);
             console.log('[ info/app ] weather information: ' + JSON.stringify(response));
-            success(temp, icon);
+            var hourly = [];
+            for (var i = 0; i < response.list.length; i++) {
+                var data = response.list[i];
+                hourly.push({
+                    time: data.dt * 1000,
+                    temp: data.main.temp - 273.15,
+                    icon: parseIconOpenWeatherMap(data.weather[0].icon)
+                });
+            }
+            success(hourly, dailyFromHourly(hourly));
         });
     } else if (source == 3) {
-        var q = "conditions";
-        if (daily) q = "forecast";
-        var url = "http://api.wunderground.com/api/" + apikey + "/" + q + "/q/" + latitude + "," + longitude + ".json";
+        var url = "http://api.wunderground.com/api/" + apikey + "/hourly/forecast/q/" + latitude + "," + longitude +
+            ".json";
         runRequest(url, function (response) {
-            var temp, icon;
             console.log('[ info/app ] weather information: ' + JSON.stringify(response));
-            if (daily) {
-                for (var i in response.forecast.simpleforecast.forecastday) {
-                    var data = response.forecast.simpleforecast.forecastday[i];
-                    var date = new Date(data.date.epoch*1000);
-                    if (sameDate(now, date)) {
-                        console.log('[ info/app ] using this information: ' + JSON.stringify(data));
-                        temp = +data.high.celsius;
-                        icon = parseIconWU(data.icon);
-                        break;
-                    }
-                }
-            } else {
-                temp = response.current_observation.temp_c;
-                icon = parseIconWU(response.current_observation.icon);
+            var hourly = [];
+            var daily = [];
+            var i, data;
+            for (i = 0; i < response.hourly_forecast.length; i++) {
+                data = response.hourly_forecast[i];
+                hourly.push({time: +data.FCTTIME.epoch * 1000, temp: +data.temp.metric, icon: parseIconWU(data.icon)});
+            }
+            for (i = 0; i < response.forecast.simpleforecast.forecastday.length; i++) {
+                data = response.forecast.simpleforecast.forecastday[i];
+                daily.push({time: data.date.epoch * 1000, temp: +data.high.celsius, icon: parseIconWU(data.icon)});
             }
-            success(temp, icon);
+            success(hourly, daily);
         });
     } else {
         // source == 2
         var baseurl = "https://api.darksky.net/forecast/" + apikey + "/" + latitude + "," + longitude + "?units=si&";
-        var exclude = "exclude=minutely,hourly,alerts,flags,";
-        if (daily) {
-            exclude += "currently"
-        } else {
-            exclude += "daily"
-        }
+        var exclude = "exclude=minutely,alerts,flags";
         runRequest(baseurl + exclude, function(response) {
-            var temp;
-            var icon;
             console.log('[ info/app ] weather information: ' + JSON.stringify(response));
-            if (daily) {
-                for (var i in response.daily.data) {
-                    var data = response.daily.data[i];
-                    var date = new Date(data.time*1000);
-                    if (sameDate(now, date)) {
-                        console.log(data);
-                        temp = data. temperatureMax;
-                        icon = data.icon;
-                        console.log('[ info/app ] using this information: ' + JSON.stringify(data));
-                        break;
-                    }
-                }
-            } else {
-                temp = response.currently.temperature;
-                icon = response.currently.icon;
+            var hourly = [{
+                time: response.currently.time * 1000,
+                temp: response.currently.temperature,
+                icon: parseIconForecastIO(response.currently.icon)
+            }];
+            var daily = [];
+            var i, data;
+            for (i = 0; i < response.hourly.data.length; i++) {
+                data = response.hourly.data[i];
+                hourly.push({time: data.time * 1000, temp: data.temperature, icon: parseIconForecastIO(data.icon)});
+            }
+            for (i = 0; i < response.daily.data.length; i++) {
+                data = response.daily.data[i];
+                daily.push({time: data.time * 1000, temp: data.temperatureMax, icon: parseIconForecastIO(data.icon)});
             }
-            temp = Math.round(temp);
-            icon = parseIconForecastIO(icon);
-            success(temp, icon);
+            success(hourly, daily);
         });
     }
 }
 
+/** Fetch the weather for the configured location, or the current position, and send it to the watch. */
+function requestWeather() {
+    var location = readConfig("CONFIG_WEATHER_LOCATION_LOCAL");
+    if (location) {
+        var loc = location.split(",");
+        fetchWeather(loc[0], loc[1]);
+    } else {
+        var found = function (pos) {
+            var coordinates = pos.coords;
+            localStorage.setItem("LAST_POSITION", JSON.stringify({
+                latitude: coordinates.latitude,
+                longitude: coordinates.longitude,
+                time: new Date().getTime()
+            }));
+            fetchWeather(coordinates.latitude, coordinates.longitude);
+        };
+        // a coarse (network based, or recent) position is good enough for the weather, and usually much
+        // cheaper; only ask for a precise one if there is none
+        navigator.geolocation.getCurrentPosition(found, function (err) {
+            navigator.geolocation.getCurrentPosition(found, function (err) {
+                failedWeatherCheck("location not found");
+            }, {enableHighAccuracy: true, timeout: 15000, maximumAge: 60000});
+        }, {enableHighAccuracy: false, timeout: 10000, maximumAge: 30 * 60000});
+    }
+}
+
+/**
+ * The weather message from the cache, for the configured location or the last position (if that is recent), without
+ * waiting for a new position.  Returns null if there is none.
+ */
+function cachedForecastMessage() {
+    var latitude, longitude;
+    var location = readConfig("CONFIG_WEATHER_LOCATION_LOCAL");
+    if (location) {
+        var loc = location.split(",");
+        latitude = +loc[0];
+        longitude = +loc[1];
+    } else {
+        var last = null;
+        try {
+            last = JSON.parse(localStorage.getItem("LAST_POSITION"));
+        } catch (e) {
+        }
+        if (last === null || new Date().getTime() - last.time > WEATHER_CACHE_MAX_AGE * 60000) return null;
+        latitude = last.latitude;
+        longitude = last.longitude;
+    }
+    var cached = findCachedWeather(+readConfig("CONFIG_WEATHER_SOURCE_LOCAL"), latitude, longitude);
+    if (cached === null) return null;
+    return forecastMessage(cached.hourly, cached.daily);
+}
+
 Pebble.addEventListener('appmessage',
     function (e) {
         console.log('[ info/app ] app message received: ' + JSON.stringify(e));
         var dict = e.payload;
+        if (dict["MSG_KEY_WEATHER_STATE"]) {
+            // when the watch received weather last (4 bytes), its refresh interval in minutes (2 bytes) and the
+            // hours after which it refreshes a forecast (see update_weather in src/settings.c)
+            var bytes = dict["MSG_KEY_WEATHER_STATE"];
+            var state = readWatchWeather() || {forecastStart: 0, forecastCount: 0};
+            state.received = ((bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24)) >>> 0) * 1000;
+            state.refresh = bytes[4] | (bytes[5] << 8);
+            state.forecastHours = bytes[6];
+            writeWatchWeather(state);
+        }
         if (dict["MSG_KEY_FETCH_WEATHER"]) {
-            var location = readConfig("CONFIG_WEATHER_LOCATION_LOCAL");
-            if (location) {
-                var loc = location.split(",");
-                fetchWeather(loc[0], loc[1]);
-            } else {
-                navigator.geolocation.getCurrentPosition(
-                    function (pos) {
-                        var coordinates = pos.coords;
-                        fetchWeather(coordinates.latitude, coordinates.longitude);
-                    },
-                    function (err) {
-                        failedWeatherCheck("location not found");
-                    },
-                    {timeout: 15000, maximumAge: 60000}
-                );
-            }
+            requestWeather();
         }
     }
 );
@@ -73,6 +73,7 @@ Window *window;
 
 /** All layers */
 Layer *layer_background;
+Layer *layer_hands;
 
 /** Buffers for strings */
 char buffer_1[30];
@@ -94,6 +95,8 @@ GFont font_open_sans;
 #ifdef PBL_COLOR
 FFont* font_main;
 FFont* font_weather;
+/** The resource font_main is loaded from. */
+static uint32_t font_main_resource;
 #else
 GFont font_main;
 GFont font_main_big;
@@ -109,12 +112,18 @@ AppTimer *timer_bluetooth_popup;
 /** The current weather information. */
 Weather weather;
 
+/** The hourly forecast the weather information is played back from. */
+Forecast forecast;
+
 /** Is the JS runtime ready? */
 bool js_ready;
 
 /** A timer used to schedule weather updates. */
 AppTimer * weather_request_timer;
 
+/** The timer that initializes the rest after the first frame (see OBSIDIAN_DEFERRED_INIT). */
+static AppTimer *timer_deferred_init;
+
 
 
 ////////////////////////////////////////////
@@ -151,24 +160,34 @@ AppTimer * weather_request_timer;
  * Handler for time ticks.
  */
 void handle_second_tick(struct tm *tick_time, TimeUnits units_changed) {
-    if (config_seconds == 0 || (tick_time->tm_sec == 0) || (tick_time->tm_sec % config_seconds == 0)) {
-      layer_mark_dirty(layer_background);
-    }
+    // only redraws if something on the face moved
+    play_forecast();
+    mark_time_changed();
 #ifdef DEBUG_ITER_COUNTER
     debug_iter += 1;
+    mark_inputs_changed(INPUT_CONFIG);
 #endif
 }
 
+/**
+ * Handler for battery state changes; only redraws if the change is visible.
+ */
+void handle_battery(BatteryChargeState state) {
+    if (set_battery_state(state)) {
+        mark_inputs_changed(INPUT_BATTERY);
+    }
+}
+
 void timer_callback_bluetooth_popup(void *data) {
     show_bluetooth_popup = false;
     timer_bluetooth_popup = NULL;
-    layer_mark_dirty(layer_background);
+    mark_inputs_changed(INPUT_POPUP);
     APP_LOG(APP_LOG_LEVEL_DEBUG, "bluetooth change callback");
 }
 
 void handle_bluetooth(bool connected) {
-    // redraw background (to turn on/off the logo)
-    layer_mark_dirty(layer_background);
+    // redraw (to turn on/off the logo)
+    mark_inputs_changed(INPUT_BLUETOOTH);
     APP_LOG(APP_LOG_LEVEL_DEBUG, "bluetooth change");
 
     bool show_popup = false;
@@ -202,6 +221,100 @@ void handle_bluetooth(bool connected) {
     }
 }
 
+#if defined(OBSIDIAN_STARTUP_PROFILE) && !defined(OBSIDIAN_PROFILE)
+/**
+ * Log the time since the last startup phase (the first one only marks the start).
+ */
+void startup_phase(const char *phase) {
+    static int64_t start = -1;
+    static int64_t last;
+    time_t s;
+    uint16_t ms;
+    time_ms(&s, &ms);
+    const int64_t now = (int64_t) s * 1000 + ms;
+    if (start < 0) {
+        start = last = now;
+    }
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "startup: %s took %d ms (%d ms since start)", phase, (int) (now - last),
+            (int) (now - start));
+    last = now;
+}
+#endif
+
+/**
+ * Load the main font.  Date formats that only show digits get a subset of the font (just the digits, punctuation and
+ * the letters of the bluetooth popup, see the font_build target of the Makefile); the font is loaded again when the
+ * date format changes which one it needs.
+ */
+void load_main_font() {
+#ifdef PBL_COLOR
+    const uint32_t resource = date_format_shows_names(config_date_format) ? RESOURCE_ID_MAIN_FFONT
+                                                                          : RESOURCE_ID_MAIN_DIGITS_FFONT;
+    if (font_main != NULL) {
+        if (resource == font_main_resource) return;
+        // the advance tables are built again for the new font
+        ffont_destroy(font_main);
+        advance_tables_destroy();
+    }
+    font_main = ffont_create_from_resource(resource);
+    font_main_resource = resource;
+    advance_tables_create();
+#else
+    font_main = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+    font_main_big = fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD);
+#endif
+}
+
+/**
+ * Load the weather font, if it is not loaded yet.
+ */
+static void load_weather_font() {
+    if (font_weather != NULL) return;
+#ifdef PBL_COLOR
+    font_weather = ffont_create_from_resource(RESOURCE_ID_WEATHER_FFONT);
+#else
+    font_weather = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_NUPE_23));
+#endif
+    advance_tables_create();
+}
+
+/**
+ * Everything the first frame does not need: services, AppMessage and the weather font.
+ */
+static void init_rest() {
+    load_weather_font();
+    STARTUP_PHASE("weather font");
+
+    bluetooth_connection_service_subscribe(handle_bluetooth);
+    battery_state_service_subscribe(handle_battery);
+    STARTUP_PHASE("services");
+
+    app_message_open(OBSIDIAN_INBOX_SIZE, OBSIDIAN_OUTBOX_SIZE);
+    app_message_register_inbox_received(inbox_received_handler);
+    STARTUP_PHASE("app message");
+}
+
+void timer_callback_deferred_init(void *data) {
+    timer_deferred_init = NULL;
+    layer_set_update_proc(layer_hands, hands_update_proc);
+    init_rest();
+}
+
+/**
+ * Update procedure of the hands layer until the first frame is drawn (the hands layer is drawn last).
+ */
+static void first_frame_update_proc(Layer *layer, GContext *ctx) {
+    hands_update_proc(layer, ctx);
+    STARTUP_PHASE("first frame");
+#ifdef OBSIDIAN_DEFERRED_INIT
+    if (timer_deferred_init == NULL) {
+        timer_deferred_init = app_timer_register(0, timer_callback_deferred_init, NULL);
+    }
+#else
+    layer_set_update_proc(layer_hands, hands_update_proc);
+#endif
+}
+
 /**
  * Window load callback.
  */
@@ -209,39 +322,59 @@ void window_load(Window *window) {
     Layer *window_layer = window_get_root_layer(window);
     GRect bounds = layer_get_bounds(window_layer);
 
-    // create layer
+    // create layers (the background is static and cached, everything that moves is drawn on top)
     layer_background = layer_create(bounds);
     layer_set_update_proc(layer_background, background_update_proc);
     layer_add_child(window_layer, layer_background);
-
-    // load fonts
-#ifdef PBL_COLOR
-    font_main = ffont_create_from_resource(RESOURCE_ID_MAIN_FFONT);
-    font_weather = ffont_create_from_resource(RESOURCE_ID_WEATHER_FFONT);
+    layer_hands = layer_create(bounds);
+    layer_set_update_proc(layer_hands, first_frame_update_proc);
+    layer_add_child(window_layer, layer_hands);
+    background_cache_invalidate();
+    STARTUP_PHASE("layers");
+
+    // load fonts (the weather font only if the first frame needs it)
+    load_main_font();
+#ifdef OBSIDIAN_DEFERRED_INIT
+    if (weather_font_needed()) {
+        load_weather_font();
+    }
 #else
-    font_main = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
-    font_main_big = fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD);
-    font_weather = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_NUPE_23));
+    load_weather_font();
 #endif
+    STARTUP_PHASE("fonts");
+    drawing_create();
+    STARTUP_PHASE("drawing");
 
     // initialize
     show_bluetooth_popup = false;
 }
 
+/**
+ * Window appear callback.
+ */
+void window_appear(Window *window) {
+    // whatever was on screen in the meantime needs to be painted over
+    mark_inputs_changed(INPUT_SCREEN);
+}
+
 /**
  * Window unload callback.
  */
 void window_unload(Window *window) {
+    layer_destroy(layer_hands);
     layer_destroy(layer_background);
+    drawing_destroy();
 #ifdef OBSIDIAN_SHOW_NUMBERS
     fonts_unload_custom_font(font_open_sans);
 #endif
 #ifdef PBL_COLOR
     ffont_destroy(font_main);
-    ffont_destroy(font_weather);
+    if (font_weather) ffont_destroy(font_weather);
 #else
-    fonts_unload_custom_font(font_weather);
+    if (font_weather) fonts_unload_custom_font(font_weather);
 #endif
+    font_main = NULL;
+    font_weather = NULL;
 }
 
 void subscribe_tick(bool also_unsubscribe) {
@@ -262,7 +395,9 @@ void subscribe_tick(bool also_unsubscribe) {
  * Initialization.
  */
 void init() {
+    STARTUP_PHASE("launch");
     read_config_all();
+    STARTUP_PHASE("config");
 
 // some alternative themes (for screenshots)
 #if defined(SCREENSHOT_ALT_THEME_1) && defined(PBL_COLOR)
@@ -382,21 +517,29 @@ void init() {
     window = window_create();
     window_set_window_handlers(window, (WindowHandlers) {
             .load = window_load,
+            .appear = window_appear,
             .unload = window_unload,
     });
+    // the background layer paints the whole window, and the frame buffer has to survive between frames for the
+    // incremental seconds pointer
+    window_set_background_color(window, GColorClear);
     window_stack_push(window, true);
 
     subscribe_tick(false);
-    bluetooth_connection_service_subscribe(handle_bluetooth);
-
-    app_message_open(OBSIDIAN_INBOX_SIZE, OBSIDIAN_OUTBOX_SIZE);
-    app_message_register_inbox_received(inbox_received_handler);
+    STARTUP_PHASE("tick");
+#ifndef OBSIDIAN_DEFERRED_INIT
+    init_rest();
+#endif
 }
 
 /**
  * De-initialisation.
  */
 void deinit() {
+    if (timer_deferred_init) {
+        app_timer_cancel(timer_deferred_init);
+        timer_deferred_init = NULL;
+    }
     tick_timer_service_unsubscribe();
     battery_state_service_unsubscribe();
     bluetooth_connection_service_unsubscribe();
@@ -413,4 +556,5 @@ int main() {
     init();
     app_event_loop();
     deinit();
+    return 0;
 }
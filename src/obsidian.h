@@ -80,9 +80,36 @@
 #define MSG_KEY_FETCH_WEATHER 102
 #define MSG_KEY_JS_READY 103
 #define MSG_KEY_WEATHER_FAILED 104
-
-// persitant storage keys (in additiona to config keys above)
+// all configuration values in one byte array (see unpack_config in src/settings.c)
+#define MSG_KEY_CONFIG 105
+// the hourly forecast as one byte array (see unpack_forecast in src/settings.c)
+#define MSG_KEY_FORECAST 106
+// sent with MSG_KEY_FETCH_WEATHER: when the weather was received last, and the refresh policy (see update_weather)
+#define MSG_KEY_WEATHER_STATE 107
+// sent with MSG_KEY_CONFIG if the weather settings changed: the watch drops its forecast and requests the weather again
+#define MSG_KEY_WEATHER_INVALID 108
+
+// values of MSG_KEY_JS_READY: the phone is ready, and it is fetching the weather already (so there is no need to
+// request it)
+#define JS_READY 1
+#define JS_READY_FETCHING 2
+
+// persitant storage keys (config keys above are only used by old versions, see migrate_config in src/settings.c)
 #define PERSIST_KEY_WEATHER 201
+#define PERSIST_KEY_CONFIG 202
+#define PERSIST_KEY_FORECAST 203
+#define PERSIST_KEY_WEATHER_REQUESTS 204
+
+// version of the configuration blob stored under PERSIST_KEY_CONFIG and sent in MSG_KEY_CONFIG (increase when
+// adding values), and its size: the version byte, 32 one-byte values and 2 two-byte values (checked against
+// config_fields in src/settings.c)
+#define CONFIG_VERSION 1
+#define CONFIG_BLOB_SIZE (1 + 32 + 2 * 2)
+
+// number of hours in the forecast (also FORECAST_HOURS in src/js/pebble-js-app.js), and the size of MSG_KEY_FORECAST:
+// the start time (4 bytes), the number of hours, and icon and temperature for every hour
+#define FORECAST_HOURS 24
+#define FORECAST_DATA_SIZE (4 + 1 + 2 * FORECAST_HOURS)
 
 
 ////////////////////////////////////////////
@@ -131,6 +158,7 @@ extern uint8_t config_date_format;
 
 extern Window *window;
 extern Layer *layer_background;
+extern Layer *layer_hands;
 extern char buffer_1[30];
 extern char buffer_2[30];
 extern GPoint center;
@@ -156,13 +184,33 @@ extern int debug_iter;
 #endif
 
 typedef struct {
+    // the time the weather was received, or the end of the hour of a played back forecast entry; the weather expires
+    // config_weather_expiration minutes later
     time_t timestamp;
     int8_t icon;
     int8_t temperature;
     bool failed;
 } __attribute__((__packed__)) Weather;
 
+typedef struct {
+    int8_t icon;
+    int8_t temperature;
+} __attribute__((__packed__)) ForecastEntry;
+
+/**
+ * The weather for count hours from start (the beginning of an hour).  The entries are a ring: the entry for the hour
+ * starting at time t is entries[(t / SECONDS_PER_HOUR) % FORECAST_HOURS].
+ */
+typedef struct {
+    time_t start;
+    uint8_t count;
+    ForecastEntry entries[FORECAST_HOURS];
+} __attribute__((__packed__)) Forecast;
+
 extern Weather weather;
+/** Is the weather available and not yet expired at the given time (whether the last request failed or not)? */
+bool weather_is_current(time_t now);
+extern Forecast forecast;
 extern bool js_ready;
 extern AppTimer * weather_request_timer;
 
@@ -177,14 +225,46 @@ extern AppTimer * weather_request_timer;
 #define OBSIDIAN_FAT_TICKS
 //#define OBSIDIAN_ONLY_RELEVANT_NUMBER
 //#define OBSIDIAN_BATTERY_USE_TEXT
+// only repaint around the seconds pointer if nothing but the seconds changed
+#define OBSIDIAN_INCREMENTAL_SECONDS
+// draw the first frame before initializing what it does not need (services, AppMessage, and the weather font if no
+// weather is shown); the rest is initialized right after it
+#define OBSIDIAN_DEFERRED_INIT
+// log the duration of every startup phase (marked with STARTUP_PHASE), up to the first frame and beyond
+//#define OBSIDIAN_STARTUP_PROFILE
+// compare the generated geometry tables (src/geometry_tables_*.h) with the points computed on the watch, and log the
+// differences
+//#define OBSIDIAN_GEOMETRY_CHECK
 
 #define OBSIDIAN_BLUETOOTH_POPUP_MS 5000
+// the weather is played back from the forecast, which is only requested again after this many hours
+#define OBSIDIAN_FORECAST_REFRESH_HOURS 6
+// no new weather request while the phone may still answer the last one (it gives up after about a minute)
+#define OBSIDIAN_WEATHER_REQUEST_TIMEOUT_S 90
 
 // 100 should be plenty
 #define OBSIDIAN_OUTBOX_SIZE 100
 #define OBSIDIAN_N_CONFIG CONFIG_END_MARKER
-// 100 + an upper bound for all the configuration items we have
-#define OBSIDIAN_INBOX_SIZE (100 + (1 + (OBSIDIAN_N_CONFIG) * (7+4)))
+// the largest message is the configuration (which may come with MSG_KEY_WEATHER_INVALID) or the forecast (which may
+// come with MSG_KEY_JS_READY): the dictionary header, a byte array tuple and an integer tuple (7 bytes of header each)
+#define OBSIDIAN_INBOX_SIZE \
+    (1 + 7 + (FORECAST_DATA_SIZE > CONFIG_BLOB_SIZE ? FORECAST_DATA_SIZE : CONFIG_BLOB_SIZE) + 7 + 4)
+
+// the host benchmark (see host/) attributes time and draw calls to the stages of the update procedure
+#ifdef OBSIDIAN_PROFILE
+void profile_stage(const char *stage);
+#define PROFILE_STAGE(stage) profile_stage(stage)
+#else
+#define PROFILE_STAGE(stage)
+#endif
+
+// the startup phases are logged on the watch with OBSIDIAN_STARTUP_PROFILE, and timed by the host benchmark
+#if defined(OBSIDIAN_STARTUP_PROFILE) || defined(OBSIDIAN_PROFILE)
+void startup_phase(const char *phase);
+#define STARTUP_PHASE(phase) startup_phase(phase)
+#else
+#define STARTUP_PHASE(phase)
+#endif
 
 #ifdef PBL_PLATFORM_EMERY
 #define PBL_IF_EMERY(x, y) (x)
@@ -18,8 +18,79 @@
 
 static void update_weather_helper(void *unused);
 
-void set_weather_timer(int timeout_min) {
-    const uint32_t timeout_ms = timeout_min * 1000 * 60;
+/**
+ * A configuration value: its key and where it is stored (1 or 2 bytes).
+ */
+typedef struct {
+    uint32_t key;
+    void *value;
+    uint8_t size;
+} ConfigField;
+
+/**
+ * All configuration values, as X(key, variable); the size of a value (1 or 2 bytes) is the size of its variable.  They
+ * are persisted together under PERSIST_KEY_CONFIG and sent by the phone in MSG_KEY_CONFIG, in this order (see
+ * unpack_config), so new values have to be added at the end (and to the layout in src/js/pebble-js-app.js).
+ */
+#define CONFIG_FIELDS(X) \
+        X(CONFIG_COLOR_OUTER_BACKGROUND, config_color_outer_background) \
+        X(CONFIG_COLOR_INNER_BACKGROUND, config_color_inner_background) \
+        X(CONFIG_COLOR_MINUTE_HAND, config_color_minute_hand) \
+        X(CONFIG_COLOR_INNER_MINUTE_HAND, config_color_inner_minute_hand) \
+        X(CONFIG_COLOR_HOUR_HAND, config_color_hour_hand) \
+        X(CONFIG_COLOR_INNER_HOUR_HAND, config_color_inner_hour_hand) \
+        X(CONFIG_COLOR_CIRCLE, config_color_circle) \
+        X(CONFIG_COLOR_TICKS, config_color_ticks) \
+        X(CONFIG_COLOR_DAY_OF_WEEK, config_color_day_of_week) \
+        X(CONFIG_COLOR_DATE, config_color_date) \
+        X(CONFIG_BATTERY_LOGO, config_battery_logo) \
+        X(CONFIG_COLOR_BATTERY_LOGO, config_color_battery_logo) \
+        X(CONFIG_COLOR_BATTERY_30, config_color_battery_30) \
+        X(CONFIG_COLOR_BATTERY_20, config_color_battery_20) \
+        X(CONFIG_COLOR_BATTERY_10, config_color_battery_10) \
+        X(CONFIG_COLOR_BATTERY_BG_30, config_color_battery_bg_30) \
+        X(CONFIG_COLOR_BATTERY_BG_20, config_color_battery_bg_20) \
+        X(CONFIG_COLOR_BATTERY_BG_10, config_color_battery_bg_10) \
+        X(CONFIG_COLOR_BLUETOOTH_LOGO, config_color_bluetooth_logo) \
+        X(CONFIG_COLOR_BLUETOOTH_LOGO_2, config_color_bluetooth_logo_2) \
+        X(CONFIG_BLUETOOTH_LOGO, config_bluetooth_logo) \
+        X(CONFIG_VIBRATE_DISCONNECT, config_vibrate_disconnect) \
+        X(CONFIG_VIBRATE_RECONNECT, config_vibrate_reconnect) \
+        X(CONFIG_MESSAGE_DISCONNECT, config_message_disconnect) \
+        X(CONFIG_MESSAGE_RECONNECT, config_message_reconnect) \
+        X(CONFIG_MINUTE_TICKS, config_minute_ticks) \
+        X(CONFIG_HOUR_TICKS, config_hour_ticks) \
+        X(CONFIG_COLOR_WEATHER, config_color_weather) \
+        X(CONFIG_WEATHER_REFRESH, config_weather_refresh) \
+        X(CONFIG_WEATHER_EXPIRATION, config_weather_expiration) \
+        X(CONFIG_SQUARE, config_square) \
+        X(CONFIG_SECONDS, config_seconds) \
+        X(CONFIG_COLOR_SECONDS, config_color_seconds) \
+        X(CONFIG_DATE_FORMAT, config_date_format)
+
+#define CONFIG_FIELD(key, variable) {key, &variable, sizeof(variable)},
+static const ConfigField config_fields[] = {
+        CONFIG_FIELDS(CONFIG_FIELD)
+};
+
+// CONFIG_BLOB_SIZE (which also sizes the inbox) is the version byte and all values
+#define CONFIG_FIELD_SIZE(key, variable) + sizeof(variable)
+_Static_assert(CONFIG_BLOB_SIZE == 1 CONFIG_FIELDS(CONFIG_FIELD_SIZE), "CONFIG_BLOB_SIZE does not match config_fields");
+
+/**
+ * When the weather was last requested from the phone, answered (with weather or a failure), and received.  Persisted
+ * under PERSIST_KEY_WEATHER_REQUESTS, so that a relaunch does not request the weather again.
+ */
+typedef struct {
+    time_t requested;
+    time_t answered;
+    time_t received;
+} __attribute__((__packed__)) WeatherRequests;
+
+static WeatherRequests weather_requests;
+
+void set_weather_timer(uint32_t timeout_s) {
+    const uint32_t timeout_ms = timeout_s * 1000;
     if (weather_request_timer) {
         if (!app_timer_reschedule(weather_request_timer, timeout_ms)) {
             weather_request_timer = app_timer_register(timeout_ms, update_weather_helper, NULL);
@@ -29,21 +100,110 @@ void set_weather_timer(int timeout_min) {
     }
 }
 
+/** Hour (since the epoch) whose forecast entry was played back last, or -1. */
+static time_t forecast_hour = -1;
+
+/**
+ * Does the forecast contain the hour starting at hour * SECONDS_PER_HOUR?
+ */
+static bool forecast_covers(time_t hour) {
+    const time_t first = forecast.start / SECONDS_PER_HOUR;
+    return hour >= first && hour < first + forecast.count;
+}
+
+/**
+ * Is the weather available and not yet expired at the given time?
+ */
+bool weather_is_current(time_t now) {
+    return weather.timestamp > 0 && (now - weather.timestamp) <= (config_weather_expiration * 60);
+}
+
+/**
+ * Is the weather currently shown (current and not failed)?
+ */
+static bool weather_is_shown(time_t now) {
+    return !weather.failed && weather_is_current(now);
+}
+
+/**
+ * Take the weather for the current hour from the forecast, if the forecast covers it (or force is set).  Returns
+ * true if the weather changed visibly.
+ */
+static bool play_forecast_hour(bool force) {
+    const time_t now = time(NULL);
+    const time_t hour = now / SECONDS_PER_HOUR;
+    if (hour == forecast_hour && !force) return false;
+    forecast_hour = hour;
+    if (!forecast_covers(hour)) return false;
+
+    const ForecastEntry *entry = &forecast.entries[hour % FORECAST_HOURS];
+    const bool changed = !weather_is_shown(now) || weather.icon != entry->icon ||
+                         weather.temperature != entry->temperature;
+    // the entry is current until the end of the hour it is for
+    weather.timestamp = (hour + 1) * SECONDS_PER_HOUR;
+    weather.icon = entry->icon;
+    weather.temperature = entry->temperature;
+    weather.failed = false;
+    return changed;
+}
+
+/**
+ * Play back the forecast: show the weather for the current hour once the hour changes.
+ */
+void play_forecast() {
+    if (play_forecast_hour(false)) {
+        mark_inputs_changed(INPUT_WEATHER);
+    }
+}
+
 /**
- * Update the weather information (and schedule a periodic timer to update again)
+ * Update the weather information, unless the last weather is recent or a request is pending already (and schedule a
+ * timer to update again).
  */
 void update_weather() {
     // return if we don't want weather information
     if (config_weather_refresh == 0) return;
 
-    const uint32_t timeout_min = config_weather_refresh;
-    set_weather_timer(timeout_min);
+    const time_t now = time(NULL);
+    time_t next = 0;
+    // the last weather is younger than the refresh interval
+    if (!weather.failed && weather_requests.received > 0) {
+        next = weather_requests.received + config_weather_refresh * SECONDS_PER_MINUTE;
+    }
+    // a recent forecast covers the current hour, it is played back on the watch
+    if (forecast_covers(now / SECONDS_PER_HOUR) &&
+        forecast.start + OBSIDIAN_FORECAST_REFRESH_HOURS * SECONDS_PER_HOUR > next) {
+        next = forecast.start + OBSIDIAN_FORECAST_REFRESH_HOURS * SECONDS_PER_HOUR;
+    }
+    // the phone did not answer the last request yet
+    if (weather_requests.requested > weather_requests.answered && weather_requests.requested <= now &&
+        weather_requests.requested + OBSIDIAN_WEATHER_REQUEST_TIMEOUT_S > next) {
+        next = weather_requests.requested + OBSIDIAN_WEATHER_REQUEST_TIMEOUT_S;
+    }
+    if (next > now) {
+        set_weather_timer((uint32_t) (next - now));
+        return;
+    }
+    set_weather_timer(config_weather_refresh * SECONDS_PER_MINUTE);
 
-    // actually update the weather by sending a request
+    // actually update the weather by sending a request (or try again soon if another message is being sent)
     DictionaryIterator *iter;
-    app_message_outbox_begin(&iter);
+    if (app_message_outbox_begin(&iter) != APP_MSG_OK) {
+        set_weather_timer(OBSIDIAN_WEATHER_REQUEST_TIMEOUT_S);
+        return;
+    }
     dict_write_uint8(iter, MSG_KEY_FETCH_WEATHER, 1);
+    // so that the phone can tell on its next start whether the weather needs to be fetched (without asking)
+    const uint32_t received = (uint32_t) weather_requests.received;
+    const uint8_t state[] = {
+            (uint8_t) received, (uint8_t) (received >> 8), (uint8_t) (received >> 16), (uint8_t) (received >> 24),
+            (uint8_t) config_weather_refresh, (uint8_t) (config_weather_refresh >> 8),
+            OBSIDIAN_FORECAST_REFRESH_HOURS
+    };
+    dict_write_data(iter, MSG_KEY_WEATHER_STATE, state, sizeof(state));
     app_message_outbox_send();
+    weather_requests.requested = now;
+    persist_write_data(PERSIST_KEY_WEATHER_REQUESTS, &weather_requests, sizeof(WeatherRequests));
     APP_LOG(APP_LOG_LEVEL_INFO, "requesting weather update");
 }
 
@@ -55,169 +215,265 @@ static void update_weather_helper(void *unused) {
 }
 
 /**
- * Helper to process new configuration.
+ * Position of every configuration key in config_fields (or -1), so that incoming values can be dispatched without
+ * searching.  Filled in by read_config_all.
+ */
+static int8_t config_field_index[OBSIDIAN_N_CONFIG + 1];
+
+/**
+ * The value a configuration field takes for a value from the phone or the persistent storage: round watches ignore
+ * config_square (so a phone sending it does not change the configuration).
+ */
+static uint8_t config_field_value8(const ConfigField *field, uint8_t value) {
+#ifdef PBL_ROUND
+    if (field->value == &config_square) return 0;
+#endif
+    return value;
+}
+
+/**
+ * Store a new configuration value from a message.  Returns true if the value changed.
+ */
+static bool sync_config_field(const ConfigField *field, const Tuple *tuple) {
+    if (field->size == 1) {
+        uint8_t *value = field->value;
+        const uint8_t new_value = config_field_value8(field, tuple->value->uint8);
+        if (*value == new_value) return false;
+        *value = new_value;
+    } else {
+        uint16_t *value = field->value;
+        if (*value == tuple->value->uint16) return false;
+        *value = tuple->value->uint16;
+    }
+    return true;
+}
+
+/**
+ * Take the configuration values from a blob (as persisted, or as sent by the phone in MSG_KEY_CONFIG): a version
+ * byte, followed by the values in the order of config_fields, 16-bit values little endian.  Values missing from
+ * blobs of older versions keep their current value, and values appended by newer versions are ignored.  Returns
+ * false if the blob cannot be read; changed is set if any value changed.
  */
-bool sync_helper(const uint32_t key, DictionaryIterator *iter, uint8_t *value) {
-    Tuple *new_tuple = dict_find(iter, key);
-    if (new_tuple == NULL) return false;
-    if ((*value) != new_tuple->value->uint8) {
-        (*value) = new_tuple->value->uint8;
-        persist_write_int(key, *value);
-        return true;
+static bool unpack_config(const uint8_t *blob, int size, bool *changed) {
+    *changed = false;
+    if (size < 1 || blob[0] == 0) return false;
+    int offset = 1;
+    for (uint8_t i = 0; i < ARRAY_LENGTH(config_fields) && offset + config_fields[i].size <= size; i++) {
+        const ConfigField *field = &config_fields[i];
+        if (field->size == 1) {
+            uint8_t *value = field->value;
+            const uint8_t new_value = config_field_value8(field, blob[offset]);
+            *changed |= *value != new_value;
+            *value = new_value;
+        } else {
+            uint16_t *value = field->value;
+            const uint16_t new_value = (uint16_t) (blob[offset] | (blob[offset + 1] << 8));
+            *changed |= *value != new_value;
+            *value = new_value;
+        }
+        offset += field->size;
     }
-    return false;
+    return true;
 }
 
 /**
- * Helper to process new configuration.
+ * Take the forecast from a MSG_KEY_FORECAST byte array: the start time (4 bytes, little endian), the number of
+ * hours, and the icon and temperature for every hour.  Returns false if the data cannot be read.
  */
-bool sync_helper_2(const uint32_t key, DictionaryIterator *iter, uint16_t *value) {
-    Tuple *new_tuple = dict_find(iter, key);
-    if (new_tuple == NULL) return false;
-    if ((*value) != new_tuple->value->uint16) {
-        (*value) = new_tuple->value->uint16;
-        persist_write_int(key, *value);
-        return true;
+static bool unpack_forecast(const uint8_t *data, int size) {
+    if (size < 5) return false;
+    const uint32_t start = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t) data[3] << 24);
+    uint8_t count = data[4];
+    if (count > FORECAST_HOURS) count = FORECAST_HOURS;
+    if (count > (size - 5) / 2) count = (uint8_t) ((size - 5) / 2);
+    if (count == 0) return false;
+
+    forecast.start = (time_t) start;
+    forecast.count = count;
+    const time_t first = forecast.start / SECONDS_PER_HOUR;
+    for (uint8_t i = 0; i < count; i++) {
+        ForecastEntry *entry = &forecast.entries[(first + i) % FORECAST_HOURS];
+        entry->icon = (int8_t) data[5 + 2 * i];
+        entry->temperature = (int8_t) data[5 + 2 * i + 1];
     }
-    return false;
+    return true;
 }
 
 void inbox_received_handler(DictionaryIterator *iter, void *context) {
     APP_LOG(APP_LOG_LEVEL_DEBUG, "received message");
-    bool dirty = false;
-    dirty |= sync_helper(CONFIG_COLOR_OUTER_BACKGROUND, iter, &config_color_outer_background);
-    dirty |= sync_helper(CONFIG_COLOR_INNER_BACKGROUND, iter, &config_color_inner_background);
-    dirty |= sync_helper(CONFIG_COLOR_MINUTE_HAND, iter, &config_color_minute_hand);
-    dirty |= sync_helper(CONFIG_COLOR_INNER_MINUTE_HAND, iter, &config_color_inner_minute_hand);
-    dirty |= sync_helper(CONFIG_COLOR_HOUR_HAND, iter, &config_color_hour_hand);
-    dirty |= sync_helper(CONFIG_COLOR_INNER_HOUR_HAND, iter, &config_color_inner_hour_hand);
-    dirty |= sync_helper(CONFIG_COLOR_CIRCLE, iter, &config_color_circle);
-    dirty |= sync_helper(CONFIG_COLOR_TICKS, iter, &config_color_ticks);
-    dirty |= sync_helper(CONFIG_COLOR_DAY_OF_WEEK, iter, &config_color_day_of_week);
-    dirty |= sync_helper(CONFIG_COLOR_DATE, iter, &config_color_date);
-    dirty |= sync_helper(CONFIG_BATTERY_LOGO, iter, &config_battery_logo);
-    dirty |= sync_helper(CONFIG_COLOR_BATTERY_LOGO, iter, &config_color_battery_logo);
-    dirty |= sync_helper(CONFIG_COLOR_BATTERY_30, iter, &config_color_battery_30);
-    dirty |= sync_helper(CONFIG_COLOR_BATTERY_20, iter, &config_color_battery_20);
-    dirty |= sync_helper(CONFIG_COLOR_BATTERY_10, iter, &config_color_battery_10);
-    dirty |= sync_helper(CONFIG_COLOR_BATTERY_BG_30, iter, &config_color_battery_bg_30);
-    dirty |= sync_helper(CONFIG_COLOR_BATTERY_BG_20, iter, &config_color_battery_bg_20);
-    dirty |= sync_helper(CONFIG_COLOR_BATTERY_BG_10, iter, &config_color_battery_bg_10);
-    dirty |= sync_helper(CONFIG_COLOR_BLUETOOTH_LOGO, iter, &config_color_bluetooth_logo);
-    dirty |= sync_helper(CONFIG_COLOR_BLUETOOTH_LOGO_2, iter, &config_color_bluetooth_logo_2);
-    dirty |= sync_helper(CONFIG_BLUETOOTH_LOGO, iter, &config_bluetooth_logo);
-    dirty |= sync_helper(CONFIG_VIBRATE_DISCONNECT, iter, &config_vibrate_disconnect);
-    dirty |= sync_helper(CONFIG_VIBRATE_RECONNECT, iter, &config_vibrate_reconnect);
-    dirty |= sync_helper(CONFIG_MESSAGE_DISCONNECT, iter, &config_message_disconnect);
-    dirty |= sync_helper(CONFIG_MESSAGE_RECONNECT, iter, &config_message_reconnect);
-    dirty |= sync_helper(CONFIG_MINUTE_TICKS, iter, &config_minute_ticks);
-    dirty |= sync_helper(CONFIG_HOUR_TICKS, iter, &config_hour_ticks);
-    dirty |= sync_helper(CONFIG_COLOR_WEATHER, iter, &config_color_weather);
-    dirty |= sync_helper_2(CONFIG_WEATHER_REFRESH, iter, &config_weather_refresh);
-    dirty |= sync_helper_2(CONFIG_WEATHER_EXPIRATION, iter, &config_weather_expiration);
-    dirty |= sync_helper(CONFIG_SQUARE, iter, &config_square);
-    dirty |= sync_helper(CONFIG_SECONDS, iter, &config_seconds);
-    dirty |= sync_helper(CONFIG_COLOR_SECONDS, iter, &config_color_seconds);
-    dirty |= sync_helper(CONFIG_DATE_FORMAT, iter, &config_date_format);
 
-    bool ask_for_weather_update = true;
+    // one pass over the message, dispatching every tuple by its key
+    bool config_changed = false;
+    Tuple *icon_tuple = NULL;
+    Tuple *temp_tuple = NULL;
+    bool weather_failed = false;
+    bool forecast_received = false;
+    bool weather_invalid = false;
+    bool phone_fetching = false;
+    for (Tuple *tuple = dict_read_first(iter); tuple != NULL; tuple = dict_read_next(iter)) {
+        if (tuple->key == MSG_KEY_CONFIG && tuple->type == TUPLE_BYTE_ARRAY) {
+            // all values at once
+            bool changed;
+            unpack_config(tuple->value->data, tuple->length, &changed);
+            config_changed |= changed;
+            continue;
+        }
+        if (tuple->key == MSG_KEY_FORECAST && tuple->type == TUPLE_BYTE_ARRAY) {
+            forecast_received |= unpack_forecast(tuple->value->data, tuple->length);
+            continue;
+        }
+        if (tuple->key <= OBSIDIAN_N_CONFIG) {
+            const int8_t index = config_field_index[tuple->key];
+            if (index >= 0) {
+                config_changed |= sync_config_field(&config_fields[index], tuple);
+            }
+            continue;
+        }
+        switch (tuple->key) {
+            case MSG_KEY_WEATHER_ICON:
+                icon_tuple = tuple;
+                break;
+            case MSG_KEY_WEATHER_TEMP:
+                temp_tuple = tuple;
+                break;
+            case MSG_KEY_WEATHER_FAILED:
+                weather_failed = true;
+                break;
+            case MSG_KEY_WEATHER_INVALID:
+                weather_invalid = true;
+                break;
+            case MSG_KEY_JS_READY:
+                js_ready = true;
+                phone_fetching = tuple->value->uint8 == JS_READY_FETCHING;
+                break;
+        }
+    }
 
-    Tuple *icon_tuple = dict_find(iter, MSG_KEY_WEATHER_ICON);
-    Tuple *temp_tuple = dict_find(iter, MSG_KEY_WEATHER_TEMP);
+    uint16_t changed = 0;
+    if (config_changed) {
+        // all changed values are persisted together
+        write_config_all();
+        // the static part of the face needs to be drawn again
+        background_cache_invalidate();
+        // make sure we update tick frequency if necessary
+        subscribe_tick(true);
+        // the date format may need the other variant of the main font
+        load_main_font();
+        changed |= INPUT_CONFIG;
+    }
+    if (weather_invalid && !forecast_received) {
+        // the weather is for other weather settings, request it again
+        forecast.count = 0;
+        weather_requests.received = 0;
+    }
+
+    bool ask_for_weather_update = true;
+    if (forecast_received) {
+        persist_write_data(PERSIST_KEY_FORECAST, &forecast, sizeof(Forecast));
+        if (play_forecast_hour(true)) {
+            changed |= INPUT_WEATHER;
+        }
+        ask_for_weather_update = false;
+    }
     if (icon_tuple && temp_tuple) {
+        // a new timestamp alone is not visible, unless the old weather was not shown
+        if (!weather_is_shown(time(NULL)) || weather.icon != icon_tuple->value->int8 ||
+            weather.temperature != temp_tuple->value->int8) {
+            changed |= INPUT_WEATHER;
+        }
         weather.timestamp = time(NULL);
         weather.icon = icon_tuple->value->int8;
         weather.temperature = temp_tuple->value->int8;
         weather.failed = false;
         persist_write_data(PERSIST_KEY_WEATHER, &weather, sizeof(Weather));
-        dirty = true;
         ask_for_weather_update = false;
     }
-    if (dict_find(iter, MSG_KEY_WEATHER_FAILED)) {
+    if (phone_fetching) {
+        // the phone fetches the weather on its own, as if it had been requested
+        weather_requests.requested = time(NULL);
+    }
+    if (forecast_received || (icon_tuple && temp_tuple) || weather_failed) {
+        weather_requests.answered = time(NULL);
+        if (!weather_failed) {
+            weather_requests.received = weather_requests.answered;
+        }
+        persist_write_data(PERSIST_KEY_WEATHER_REQUESTS, &weather_requests, sizeof(WeatherRequests));
+    }
+    if (weather_failed) {
         // retry early when weather update failed
-        set_weather_timer(10);
+        set_weather_timer(10 * SECONDS_PER_MINUTE);
         ask_for_weather_update = false;
+        if (!weather.failed) {
+            changed |= INPUT_WEATHER;
+        }
         weather.failed = true;
     }
 
-    if (dict_find(iter, MSG_KEY_JS_READY)) {
-        js_ready = true;
-    }
-    if (dirty) {
-        // make sure we update tick frequency if necessary
-        subscribe_tick(true);
-        layer_mark_dirty(layer_background);
-    }
+    mark_inputs_changed(changed);
     if (ask_for_weather_update) {
         update_weather();
     }
-
-#ifdef PBL_ROUND
-    config_square = false;
-#endif
 }
 
 /**
- * Read a value from the persistent storage (or load the default value).
+ * Write all configuration values to the persistent storage, as one blob.
  */
-void read_config(const uint32_t key, uint8_t *value) {
-    if (persist_exists(key)) {
-        *value = persist_read_int(key);
-    } else {
-        persist_write_int(key, *value);
+void write_config_all() {
+    uint8_t blob[CONFIG_BLOB_SIZE];
+    size_t size = 0;
+    blob[size++] = CONFIG_VERSION;
+    for (uint8_t i = 0; i < ARRAY_LENGTH(config_fields); i++) {
+        const ConfigField *field = &config_fields[i];
+        if (field->size == 1) {
+            blob[size++] = *(uint8_t *) field->value;
+        } else {
+            const uint16_t value = *(uint16_t *) field->value;
+            blob[size++] = (uint8_t) (value & 0xff);
+            blob[size++] = (uint8_t) (value >> 8);
+        }
     }
+    persist_write_data(PERSIST_KEY_CONFIG, blob, size);
 }
 
 /**
- * Read a value from the persistent storage (or load the default value).
+ * Read the configuration blob.  Returns false if there is no blob (or one we cannot read).
  */
-void read_config_2(const uint32_t key, uint16_t *value) {
-    if (persist_exists(key)) {
-        *value = persist_read_int(key);
-    } else {
-        persist_write_int(key, *value);
-    }
+static bool read_config_blob() {
+    uint8_t blob[CONFIG_BLOB_SIZE];
+    const int size = persist_read_data(PERSIST_KEY_CONFIG, blob, sizeof(blob));
+    bool changed;
+    return unpack_config(blob, size, &changed);
 }
 
+/**
+ * Move the configuration from one persistent key per value (as stored by versions before the blob) into the blob.
+ */
+static void migrate_config() {
+    for (uint8_t i = 0; i < ARRAY_LENGTH(config_fields); i++) {
+        const ConfigField *field = &config_fields[i];
+        if (!persist_exists(field->key)) continue;
+        if (field->size == 1) {
+            *(uint8_t *) field->value = (uint8_t) persist_read_int(field->key);
+        } else {
+            *(uint16_t *) field->value = (uint16_t) persist_read_int(field->key);
+        }
+        persist_delete(field->key);
+    }
+    write_config_all();
+}
 
 /**
  * Read all items from the configuration storage.
  */
 void read_config_all() {
-    read_config(CONFIG_COLOR_OUTER_BACKGROUND, &config_color_outer_background);
-    read_config(CONFIG_COLOR_INNER_BACKGROUND, &config_color_inner_background);
-    read_config(CONFIG_COLOR_MINUTE_HAND, &config_color_minute_hand);
-    read_config(CONFIG_COLOR_INNER_MINUTE_HAND, &config_color_inner_minute_hand);
-    read_config(CONFIG_COLOR_HOUR_HAND, &config_color_hour_hand);
-    read_config(CONFIG_COLOR_INNER_HOUR_HAND, &config_color_inner_hour_hand);
-    read_config(CONFIG_COLOR_CIRCLE, &config_color_circle);
-    read_config(CONFIG_COLOR_TICKS, &config_color_ticks);
-    read_config(CONFIG_COLOR_DAY_OF_WEEK, &config_color_day_of_week);
-    read_config(CONFIG_COLOR_DATE, &config_color_date);
-    read_config(CONFIG_BATTERY_LOGO, &config_battery_logo);
-    read_config(CONFIG_COLOR_BATTERY_LOGO, &config_color_battery_logo);
-    read_config(CONFIG_COLOR_BATTERY_30, &config_color_battery_30);
-    read_config(CONFIG_COLOR_BATTERY_20, &config_color_battery_20);
-    read_config(CONFIG_COLOR_BATTERY_10, &config_color_battery_10);
-    read_config(CONFIG_COLOR_BATTERY_BG_30, &config_color_battery_bg_30);
-    read_config(CONFIG_COLOR_BATTERY_BG_20, &config_color_battery_bg_20);
-    read_config(CONFIG_COLOR_BATTERY_BG_10, &config_color_battery_bg_10);
-    read_config(CONFIG_COLOR_BLUETOOTH_LOGO, &config_color_bluetooth_logo);
-    read_config(CONFIG_COLOR_BLUETOOTH_LOGO_2, &config_color_bluetooth_logo_2);
-    read_config(CONFIG_BLUETOOTH_LOGO, &config_bluetooth_logo);
-    read_config(CONFIG_VIBRATE_DISCONNECT, &config_vibrate_disconnect);
-    read_config(CONFIG_VIBRATE_RECONNECT, &config_vibrate_reconnect);
-    read_config(CONFIG_MESSAGE_DISCONNECT, &config_message_disconnect);
-    read_config(CONFIG_MESSAGE_RECONNECT, &config_message_reconnect);
-    read_config(CONFIG_MINUTE_TICKS, &config_minute_ticks);
-    read_config(CONFIG_HOUR_TICKS, &config_hour_ticks);
-    read_config(CONFIG_COLOR_WEATHER, &config_color_weather);
-    read_config_2(CONFIG_WEATHER_REFRESH, &config_weather_refresh);
-    read_config_2(CONFIG_WEATHER_EXPIRATION, &config_weather_expiration);
-    read_config(CONFIG_SQUARE, &config_square);
-    read_config(CONFIG_SECONDS, &config_seconds);
-    read_config(CONFIG_COLOR_SECONDS, &config_color_seconds);
-    read_config(CONFIG_DATE_FORMAT, &config_date_format);
+    memset(config_field_index, -1, sizeof(config_field_index));
+    for (uint8_t i = 0; i < ARRAY_LENGTH(config_fields); i++) {
+        config_field_index[config_fields[i].key] = i;
+    }
+
+    if (!read_config_blob()) {
+        migrate_config();
+    }
 
 #ifdef DEBUG_SQUARE
     config_square = true;
@@ -226,11 +482,18 @@ void read_config_all() {
     config_square = false;
 #endif
 
-    if (persist_exists(PERSIST_KEY_WEATHER)) {
-        persist_read_data(PERSIST_KEY_WEATHER, &weather, sizeof(Weather));
-    } else {
+    if (persist_read_data(PERSIST_KEY_WEATHER, &weather, sizeof(Weather)) != sizeof(Weather)) {
         weather.timestamp = 0;
     }
+    if (persist_read_data(PERSIST_KEY_FORECAST, &forecast, sizeof(Forecast)) != sizeof(Forecast)) {
+        forecast.count = 0;
+    }
+    if (persist_read_data(PERSIST_KEY_WEATHER_REQUESTS, &weather_requests, sizeof(WeatherRequests)) !=
+        sizeof(WeatherRequests)) {
+        memset(&weather_requests, 0, sizeof(WeatherRequests));
+    }
+    // the weather may have moved on to another hour since the last launch
+    play_forecast_hour(true);
 
     js_ready = false;
 }
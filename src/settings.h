@@ -18,8 +18,11 @@
 #include "obsidian.h"
 
 void update_weather();
+void play_forecast();
 void inbox_received_handler(DictionaryIterator *iter, void *context);
 void read_config_all();
+void write_config_all();
 void subscribe_tick(bool also_unsubscribe);
+void load_main_font();
 
 #endif //OBSIDIAN_CONFIGURATION_H